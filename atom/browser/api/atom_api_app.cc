@@ -35,10 +35,15 @@
 #include "base/files/file_util.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/path_service.h"
+#include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_content_browser_client.h"
+#include "brave/browser/resource_coordinator/guest_tab_manager.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "brave/common/workers/worker_bindings.h"
+#include "brave/common/workers/worker_message.h"
+#include "brave/common/workers/worker_pool.h"
+#include "chrome/browser/browser_process.h"
 #include "chrome/common/chrome_paths.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "content/browser/plugin_service_impl.h"
@@ -522,6 +527,9 @@ App::~App() {
   atom::Browser::Get()->RemoveObserver(this);
   net::NetworkChangeNotifier::RemoveMaxBandwidthObserver(this);
   content::GpuDataManager::GetInstance()->RemoveObserver(this);
+  for (const auto& pool : worker_pools_)
+    pool.second->Shutdown();
+  worker_pools_.clear();
 }
 
 void App::OnBeforeQuit(bool* prevent_default) {
@@ -797,11 +805,41 @@ void App::SendMemoryPressureAlert() {
       base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL);
 }
 
+void App::SetTabMemoryBudget(double bytes) {
+  auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+  if (tab_manager && bytes >= 0)
+    tab_manager->SetMemoryBudget(static_cast<uint64_t>(bytes));
+}
+
+v8::Local<v8::Value> App::GetTabDiscardStats() {
+  auto tab_manager = static_cast<resource_coordinator::GuestTabManager*>(
+      g_browser_process->GetTabManager());
+  if (!tab_manager)
+    return v8::Null(isolate());
+
+  resource_coordinator::GuestTabManager::DiscardStats stats =
+      tab_manager->GetDiscardStats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+  dict.Set("memoryBudget", static_cast<double>(stats.memory_budget));
+  dict.Set("tabMemory", static_cast<double>(stats.tab_memory));
+  dict.Set("discards", stats.discards);
+  dict.Set("reclaimedBytes", static_cast<double>(stats.reclaimed_bytes));
+  dict.Set("restores", stats.restores);
+  dict.Set("averageRestoreMs", stats.average_restore_time.InMillisecondsF());
+  dict.Set("maxRestoreMs", stats.max_restore_time.InMillisecondsF());
+  return dict.GetHandle();
+}
+
 void App::PostMessage(int worker_id,
                       v8::Local<v8::Value> message,
                       mate::Arguments* args) {
-  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message))
-    args->ThrowError("Eror serializing message");
+  v8::Local<v8::Value> transfer_list;
+  args->GetNext(&transfer_list);
+  std::string error;
+  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message,
+                                        transfer_list, &error))
+    args->ThrowError(error);
 }
 
 void App::StopWorker(mate::Arguments* args) {
@@ -833,6 +871,80 @@ void App::StartWorker(mate::Arguments* args) {
   args->Return(worker_id);
 }
 
+std::vector<int> App::StartWorkerPool(const std::string& module_name,
+                                      int size,
+                                      mate::Arguments* args) {
+  if (size <= 0) {
+    args->ThrowError("`size` must be a positive Number");
+    return std::vector<int>();
+  }
+
+  // There is one warm pool per module.
+  if (base::ContainsKey(worker_pools_, module_name)) {
+    args->ThrowError("A worker pool is already running " + module_name);
+    return std::vector<int>();
+  }
+
+  scoped_refptr<brave::WorkerPool> pool(
+      new brave::WorkerPool(module_name, this));
+  std::vector<int> worker_ids = pool->Start(size);
+  if (!worker_ids.empty())
+    worker_pools_[module_name] = pool;
+  return worker_ids;
+}
+
+void App::PostPoolMessage(const std::string& module_name,
+                          v8::Local<v8::Value> message,
+                          mate::Arguments* args) {
+  auto it = worker_pools_.find(module_name);
+  if (it == worker_pools_.end()) {
+    args->ThrowError("No worker pool is running " + module_name);
+    return;
+  }
+
+  v8::Local<v8::Value> transfer_list;
+  args->GetNext(&transfer_list);
+  std::unique_ptr<brave::WorkerMessage> worker_message(
+      new brave::WorkerMessage);
+  std::string error;
+  if (!worker_message->Serialize(isolate(), message, transfer_list, &error)) {
+    args->ThrowError(error);
+    return;
+  }
+  it->second->PostMessage(std::move(worker_message));
+}
+
+v8::Local<v8::Value> App::GetWorkerPoolStats(const std::string& module_name) {
+  auto it = worker_pools_.find(module_name);
+  if (it == worker_pools_.end())
+    return v8::Null(isolate());
+
+  brave::WorkerPool::Stats stats = it->second->GetStats();
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate());
+  dict.Set("workers", static_cast<uint32_t>(stats.workers));
+  dict.Set("idleWorkers", static_cast<uint32_t>(stats.idle_workers));
+  dict.Set("queueDepth", static_cast<uint32_t>(stats.queue_depth));
+  dict.Set("completed", static_cast<double>(stats.completed));
+  dict.Set("stolen", static_cast<double>(stats.stolen));
+  dict.Set("averageWaitMs", stats.average_wait.InMillisecondsF());
+  dict.Set("maxWaitMs", stats.max_wait.InMillisecondsF());
+  dict.Set("averageRunMs", stats.average_run.InMillisecondsF());
+  return dict.GetHandle();
+}
+
+void App::StopWorkerPool(const std::string& module_name) {
+  auto it = worker_pools_.find(module_name);
+  if (it == worker_pools_.end())
+    return;
+  it->second->Shutdown();
+  worker_pools_.erase(it);
+}
+
+void App::OnWorkerLoadError(int worker_id) {
+  for (const auto& pool : worker_pools_)
+    pool.second->RemoveWorker(worker_id);
+}
+
 #if defined(OS_WIN)
 v8::Local<v8::Value> App::GetJumpListSettings() {
   JumpList jump_list(atom::Browser::Get()->GetAppUserModelID());
@@ -960,9 +1072,15 @@ void App::BuildPrototype(
       .SetMethod("isAccessibilitySupportEnabled",
                  &App::IsAccessibilitySupportEnabled)
       .SetMethod("sendMemoryPressureAlert", &App::SendMemoryPressureAlert)
+      .SetMethod("setTabMemoryBudget", &App::SetTabMemoryBudget)
+      .SetMethod("getTabDiscardStats", &App::GetTabDiscardStats)
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
       .SetMethod("stopWorker", &App::StopWorker)
+      .SetMethod("_startWorkerPool", &App::StartWorkerPool)
+      .SetMethod("_postPoolMessage", &App::PostPoolMessage)
+      .SetMethod("_getWorkerPoolStats", &App::GetWorkerPoolStats)
+      .SetMethod("_stopWorkerPool", &App::StopWorkerPool)
       .SetMethod("disableHardwareAcceleration",
                  &App::DisableHardwareAcceleration);
 }
@@ -5,13 +5,16 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_APP_H_
 #define ATOM_BROWSER_API_ATOM_API_APP_H_
 
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/event_emitter.h"
 #include "atom/browser/atom_browser_client.h"
 #include "atom/browser/browser_observer.h"
 #include "atom/common/native_mate_converters/callback.h"
+#include "base/memory/ref_counted.h"
 #include "chrome/browser/process_singleton.h"
 #include "content/public/browser/gpu_data_manager_observer.h"
 #include "content/public/browser/notification_observer.h"
@@ -24,6 +27,10 @@ namespace base {
 class FilePath;
 }
 
+namespace brave {
+class WorkerPool;
+}
+
 namespace mate {
 class Arguments;
 }  // namespace mate
@@ -55,6 +62,10 @@ class App : public AtomBrowserClient::Delegate,
                       int render_process_id,
                       int render_frame_id);
 
+  // Called when the worker |worker_id| stopped because its module could not
+  // be loaded, removes it from its pool.
+  void OnWorkerLoadError(int worker_id);
+
  protected:
   explicit App(v8::Isolate* isolate);
   ~App() override;
@@ -126,11 +137,21 @@ class App : public AtomBrowserClient::Delegate,
   void DisableHardwareAcceleration(mate::Arguments* args);
   bool IsAccessibilitySupportEnabled();
   void SendMemoryPressureAlert();
+  void SetTabMemoryBudget(double bytes);
+  v8::Local<v8::Value> GetTabDiscardStats();
   void PostMessage(int worker_id,
                   v8::Local<v8::Value> message,
                   mate::Arguments* args);
   void StartWorker(mate::Arguments* args);
   void StopWorker(mate::Arguments* args);
+  std::vector<int> StartWorkerPool(const std::string& module_name,
+                                   int size,
+                                   mate::Arguments* args);
+  void PostPoolMessage(const std::string& module_name,
+                       v8::Local<v8::Value> message,
+                       mate::Arguments* args);
+  v8::Local<v8::Value> GetWorkerPoolStats(const std::string& module_name);
+  void StopWorkerPool(const std::string& module_name);
 
 #if defined(OS_WIN)
   // Get the current Jump List settings.
@@ -144,6 +165,9 @@ class App : public AtomBrowserClient::Delegate,
 
   std::unique_ptr<ProcessSingleton> process_singleton_;
 
+  // Warm worker pools by module name.
+  std::map<std::string, scoped_refptr<brave::WorkerPool>> worker_pools_;
+
   DISALLOW_COPY_AND_ASSIGN(App);
 };
 
@@ -4,16 +4,25 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_user_prefs.h"
 
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/auto_reset.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
 #include "base/values.h"
+#include "chrome/browser/chrome_notification_types.h"
 #include "chrome/browser/profiles/profile.h"
 #include "components/pref_registry/pref_registry_syncable.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/scoped_user_pref_update.h"
 #include "components/sync_preferences/pref_service_syncable.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/notification_source.h"
 #include "native_mate/object_template_builder.h"
 
 namespace mate {
@@ -46,9 +55,128 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+// Splits |path| into the longest registered pref name it starts with and the
+// keys inside of that pref.
+const PrefService::Preference* FindPref(PrefService* prefs,
+                                        const std::string& path,
+                                        std::vector<std::string>* keys) {
+  size_t end = path.size();
+  while (end != std::string::npos && end > 0) {
+    const PrefService::Preference* pref =
+        prefs->FindPreference(path.substr(0, end));
+    if (pref) {
+      if (end < path.size())
+        *keys = base::SplitString(path.substr(end + 1), ".",
+                                  base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL);
+      return pref;
+    }
+    end = path.rfind('.', end - 1);
+  }
+  return nullptr;
+}
+
+const base::Value* GetChild(const base::Value* value, const std::string& key) {
+  const base::DictionaryValue* dict;
+  const base::ListValue* list;
+  const base::Value* child = nullptr;
+  size_t index;
+  if (value->GetAsDictionary(&dict))
+    dict->GetWithoutPathExpansion(key, &child);
+  else if (value->GetAsList(&list) && base::StringToSizeT(key, &index))
+    list->Get(index, &child);
+  return child;
+}
+
+base::Value* GetChild(base::Value* value, const std::string& key) {
+  return const_cast<base::Value*>(
+      GetChild(static_cast<const base::Value*>(value), key));
+}
+
+// Whether SetChild(|parent|, |key|, ...) would succeed, so a pref is only
+// updated when the change can be made.
+bool CanSetChild(const base::Value* parent, const std::string& key,
+                 bool remove) {
+  if (parent->type() == base::Value::Type::DICTIONARY)
+    return !remove || GetChild(parent, key);
+
+  const base::ListValue* list;
+  size_t index;
+  if (!parent->GetAsList(&list) || !base::StringToSizeT(key, &index))
+    return false;
+  return remove ? index < list->GetSize() : index <= list->GetSize();
+}
+
+// Sets |key| of the dictionary or list |parent|, a list index can be at most
+// the size of the list. Removes |key| if |value| is null.
+bool SetChild(base::Value* parent,
+              const std::string& key,
+              std::unique_ptr<base::Value> value) {
+  base::DictionaryValue* dict;
+  if (parent->GetAsDictionary(&dict)) {
+    if (!value)
+      return dict->RemoveWithoutPathExpansion(key, nullptr);
+    dict->SetWithoutPathExpansion(key, std::move(value));
+    return true;
+  }
+
+  base::ListValue* list;
+  size_t index;
+  if (!parent->GetAsList(&list) || !base::StringToSizeT(key, &index))
+    return false;
+  if (!value)
+    return list->Remove(index, nullptr);
+  if (index == list->GetSize()) {
+    list->Append(std::move(value));
+    return true;
+  }
+  return index < list->GetSize() && list->Set(index, std::move(value));
+}
+
+bool SetAtPath(base::Value* root,
+               const std::vector<std::string>& keys,
+               std::unique_ptr<base::Value> value) {
+  base::Value* parent = root;
+  for (size_t i = 0; parent && i < keys.size() - 1; ++i)
+    parent = GetChild(parent, keys[i]);
+  return parent && SetChild(parent, keys.back(), std::move(value));
+}
+
+// Whether |path| is |parent| or a path inside of it.
+bool IsSameOrChildPath(const std::string& path, const std::string& parent) {
+  return base::StartsWith(path, parent, base::CompareCase::SENSITIVE) &&
+      (path.size() == parent.size() || path[parent.size()] == '.');
+}
+
+void DeepFreeze(v8::Local<v8::Context> context, v8::Local<v8::Value> value) {
+  if (!value->IsObject())
+    return;
+  v8::Local<v8::Object> object = value.As<v8::Object>();
+  v8::Local<v8::Array> names;
+  if (object->GetOwnPropertyNames(context).ToLocal(&names)) {
+    for (uint32_t i = 0; i < names->Length(); ++i) {
+      v8::Local<v8::Value> name;
+      v8::Local<v8::Value> child;
+      if (names->Get(context, i).ToLocal(&name) &&
+          object->Get(context, name).ToLocal(&child))
+        DeepFreeze(context, child);
+    }
+  }
+  ignore_result(
+      object->SetIntegrityLevel(context, v8::IntegrityLevel::kFrozen));
+}
+
+}  // namespace
+
 UserPrefs::UserPrefs(v8::Isolate* isolate,
                  content::BrowserContext* browser_context)
-      : browser_context_(browser_context) {
+      : browser_context_(browser_context),
+        pref_change_registrar_(new PrefChangeRegistrar) {
+  pref_change_registrar_->Init(profile()->GetPrefs());
+  // The prefs go away before the profile's user data.
+  registrar_.Add(this, chrome::NOTIFICATION_PROFILE_DESTROYED,
+                 content::Source<Profile>(profile()));
   Init(isolate);
 }
 
@@ -162,6 +290,120 @@ void UserPrefs::SetDoublePref(const std::string& path,
   profile()->GetPrefs()->SetDouble(path, value);
 }
 
+v8::Local<v8::Value> UserPrefs::GetPref(v8::Isolate* isolate,
+                                        const std::string& path) {
+  auto cached = cache_.find(path);
+  if (cached != cache_.end())
+    return v8::Local<v8::Value>::New(isolate, cached->second);
+  if (!pref_change_registrar_)
+    return v8::Null(isolate);
+
+  std::vector<std::string> keys;
+  const PrefService::Preference* pref =
+      FindPref(profile()->GetPrefs(), path, &keys);
+  if (!pref)
+    return v8::Null(isolate);
+
+  // Only convert the part that was asked for.
+  const base::Value* value = pref->GetValue();
+  for (size_t i = 0; value && i < keys.size(); ++i)
+    value = GetChild(value, keys[i]);
+  if (!value)
+    return v8::Null(isolate);
+
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::Local<v8::Value> result = V8ValueConverter().ToV8Value(value, context);
+  DeepFreeze(context, result);
+  cache_[path].Reset(isolate, result);
+
+  if (!pref_change_registrar_->IsObserved(pref->name())) {
+    pref_change_registrar_->Add(pref->name(),
+        base::Bind(&UserPrefs::OnPrefChanged, base::Unretained(this)));
+  }
+  return result;
+}
+
+bool UserPrefs::SetPref(const std::string& path, v8::Local<v8::Value> value) {
+  std::unique_ptr<base::Value> converted(V8ValueConverter().FromV8Value(
+      value, isolate()->GetCurrentContext()));
+  if (!converted)
+    return false;
+  return PatchPref(path, std::move(converted));
+}
+
+bool UserPrefs::RemovePref(const std::string& path) {
+  return PatchPref(path, nullptr);
+}
+
+bool UserPrefs::PatchPref(const std::string& path,
+                          std::unique_ptr<base::Value> value) {
+  if (!pref_change_registrar_)
+    return false;
+
+  PrefService* prefs = profile()->GetPrefs();
+  std::vector<std::string> keys;
+  const PrefService::Preference* pref = FindPref(prefs, path, &keys);
+  if (!pref)
+    return false;
+
+  if (keys.empty()) {
+    base::AutoReset<std::string> patching(&patching_path_, path);
+    if (!value) {
+      prefs->ClearPref(pref->name());
+      return true;
+    }
+    if (value->type() != pref->GetType())
+      return false;
+    prefs->Set(pref->name(), *value);
+    return true;
+  }
+
+  // Don't make the pref a user value when there is nothing to change.
+  const base::Value* parent = pref->GetValue();
+  for (size_t i = 0; parent && i < keys.size() - 1; ++i)
+    parent = GetChild(parent, keys[i]);
+  if (!parent || !CanSetChild(parent, keys.back(), !value))
+    return false;
+
+  // Changing a list can shift its other items, so all of it is invalidated.
+  std::string changed = path;
+  if (parent->type() == base::Value::Type::LIST)
+    changed.resize(changed.rfind('.'));
+  base::AutoReset<std::string> patching(&patching_path_, changed);
+
+  if (pref->GetType() == base::Value::Type::DICTIONARY) {
+    DictionaryPrefUpdate update(prefs, pref->name());
+    return SetAtPath(update.Get(), keys, std::move(value));
+  }
+  if (pref->GetType() == base::Value::Type::LIST) {
+    ListPrefUpdate update(prefs, pref->name());
+    return SetAtPath(update.Get(), keys, std::move(value));
+  }
+  return false;
+}
+
+void UserPrefs::OnPrefChanged(const std::string& pref_name) {
+  // A patch only changes the values on its path, anything else in the pref
+  // can stay cached.
+  const std::string& changed =
+      patching_path_.empty() ? pref_name : patching_path_;
+  for (auto it = cache_.begin(); it != cache_.end();) {
+    if (IsSameOrChildPath(it->first, changed) ||
+        IsSameOrChildPath(changed, it->first))
+      it = cache_.erase(it);
+    else
+      ++it;
+  }
+}
+
+void UserPrefs::Observe(int type,
+                        const content::NotificationSource& source,
+                        const content::NotificationDetails& details) {
+  DCHECK_EQ(chrome::NOTIFICATION_PROFILE_DESTROYED, type);
+  pref_change_registrar_.reset();
+  cache_.clear();
+}
+
 double UserPrefs::GetDefaultZoomLevel() {
   return profile()->GetZoomLevelPrefs()->GetDefaultZoomLevelPref();
 }
@@ -208,6 +450,10 @@ void UserPrefs::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("setDoublePref", &UserPrefs::SetDoublePref)
       // .SetMethod("setFilePathPref", &UserPrefs::SetFilePathPref)
 
+      .SetMethod("getPref", &UserPrefs::GetPref)
+      .SetMethod("setPref", &UserPrefs::SetPref)
+      .SetMethod("removePref", &UserPrefs::RemovePref)
+
       .SetMethod("getDefaultZoomLevel", &UserPrefs::GetDefaultZoomLevel)
       .SetMethod("setDefaultZoomLevel", &UserPrefs::SetDefaultZoomLevel);
 }
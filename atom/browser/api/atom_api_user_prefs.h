@@ -5,16 +5,23 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 #define ATOM_BROWSER_API_ATOM_API_USER_PREFS_H_
 
+#include <map>
+#include <memory>
 #include <string>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
 #include "brave/browser/brave_browser_context.h"
+#include "content/public/browser/notification_observer.h"
+#include "content/public/browser/notification_registrar.h"
 #include "native_mate/handle.h"
 
+class PrefChangeRegistrar;
+
 namespace base {
 class DictionaryValue;
 class ListValue;
+class Value;
 }
 
 class Profile;
@@ -23,7 +30,8 @@ namespace atom {
 
 namespace api {
 
-class UserPrefs : public mate::TrackableObject<UserPrefs> {
+class UserPrefs : public mate::TrackableObject<UserPrefs>,
+                  public content::NotificationObserver {
  public:
   static mate::Handle<UserPrefs> Create(v8::Isolate* isolate,
                                   content::BrowserContext* browser_context);
@@ -73,14 +81,38 @@ class UserPrefs : public mate::TrackableObject<UserPrefs> {
   void SetDefaultIntegerPref(const std::string& path, int value);
   void SetDefaultDoublePref(const std::string& path, double value);
 
+  // Path scoped access, |path| is a pref name followed by the dictionary keys
+  // or list indices inside of it, e.g. "app_state.tabs.3". Values returned
+  // by GetPref are frozen and shared between calls until the pref changes.
+  v8::Local<v8::Value> GetPref(v8::Isolate* isolate, const std::string& path);
+  bool SetPref(const std::string& path, v8::Local<v8::Value> value);
+  bool RemovePref(const std::string& path);
+
   double GetDefaultZoomLevel();
   void SetDefaultZoomLevel(double zoom);
 
   Profile* profile();
 
  private:
+  // content::NotificationObserver:
+  void Observe(int type,
+               const content::NotificationSource& source,
+               const content::NotificationDetails& details) override;
+
+  // Replaces the value at |path| with |value|, or removes it when |value|
+  // is null, updating the pref in place.
+  bool PatchPref(const std::string& path, std::unique_ptr<base::Value> value);
+  void OnPrefChanged(const std::string& pref_name);
+
   content::BrowserContext* browser_context_;  // not owned
 
+  content::NotificationRegistrar registrar_;
+  // Observes the prefs with values in |cache_|.
+  std::unique_ptr<PrefChangeRegistrar> pref_change_registrar_;
+  std::map<std::string, v8::Global<v8::Value>> cache_;
+  // The path changed by the PatchPref in progress.
+  std::string patching_path_;
+
   DISALLOW_COPY_AND_ASSIGN(UserPrefs);
 };
 
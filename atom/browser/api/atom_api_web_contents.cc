@@ -6,6 +6,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_web_contents.h"
 
@@ -28,6 +29,7 @@
 #include "atom/browser/web_contents_preferences.h"
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/event_emitter_caller.h"
+#include "atom/common/api/shared_ring_buffer.h"
 #include "atom/common/color_util.h"
 #include "atom/common/mouse_util.h"
 #include "atom/common/native_mate_converters/blink_converter.h"
@@ -41,6 +43,7 @@
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/options_switches.h"
+#include "base/memory/shared_memory.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/browser/brave_browser_context.h"
@@ -1299,6 +1302,11 @@ void WebContents::RenderViewDeleted(content::RenderViewHost* render_view_host) {
   Emit("render-view-deleted", render_view_host->GetProcess()->GetID());
 }
 
+void WebContents::RenderFrameDeleted(
+    content::RenderFrameHost* render_frame_host) {
+  ring_buffers_.erase(render_frame_host);
+}
+
 void WebContents::RenderProcessGone(base::TerminationStatus status) {
   Emit("crashed");
 }
@@ -1528,7 +1536,13 @@ bool WebContents::OnMessageReceived(const IPC::Message& message,
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message, OnRendererMessage)
     IPC_MESSAGE_FORWARD_DELAY_REPLY(AtomViewHostMsg_Message_Sync, &helper,
                                     FrameDispatchHelper::OnRendererMessageSync)
+    // The channel tells the listeners which kind of reply to send.
+    IPC_MESSAGE_FORWARD_DELAY_REPLY(AtomViewHostMsg_Message_Sync_Serialized,
+                                    &helper,
+                                    FrameDispatchHelper::OnRendererMessageSync)
     IPC_MESSAGE_HANDLER(AtomViewHostMsg_Message_Shared, OnRendererMessageShared)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_OpenRingBuffer, OnOpenRingBuffer)
+    IPC_MESSAGE_HANDLER(AtomViewHostMsg_RingBufferSignal, OnRingBufferSignal)
     IPC_MESSAGE_HANDLER_CODE(ViewHostMsg_SetCursor, OnCursorChange,
                              handled = false)
     IPC_MESSAGE_UNHANDLED(handled = false)
@@ -2772,6 +2786,50 @@ void WebContents::OnRendererMessageShared(
   Emit("ipc-message", args);
 }
 
+void WebContents::OnOpenRingBuffer(content::RenderFrameHost* sender,
+                                   const base::SharedMemoryHandle& handle,
+                                   uint32_t capacity) {
+  std::unique_ptr<SharedRingBuffer> buffer =
+      SharedRingBuffer::OpenConsumer(handle, capacity);
+  if (!buffer) {
+    base::SharedMemory::CloseHandle(handle);
+    ring_buffers_.erase(sender);
+    return;
+  }
+  ring_buffers_[sender] = std::move(buffer);
+}
+
+void WebContents::OnRingBufferSignal(content::RenderFrameHost* sender) {
+  auto it = ring_buffers_.find(sender);
+  if (it == ring_buffers_.end())
+    return;
+
+  // Messages written from here on get a new signal.
+  SharedRingBuffer* buffer = it->second.get();
+  buffer->ClearSignal();
+
+  std::vector<uint8_t> record;
+  while (!is_being_destroyed_ && buffer->Read(&record)) {
+    v8::HandleScope handle_scope(isolate());
+    v8::TryCatch try_catch(isolate());
+    v8::Local<v8::Context> context = isolate()->GetCurrentContext();
+    v8::ValueDeserializer deserializer(isolate(), record.data(),
+                                       record.size());
+    v8::Local<v8::Value> args;
+    if (!deserializer.ReadHeader(context).FromMaybe(false) ||
+        !deserializer.ReadValue(context).ToLocal(&args) ||
+        !args->IsArray())
+      continue;
+
+    // webContents.emit(channel, new Event(), args...);
+    Emit("ipc-message", args);
+
+    // A listener may have destroyed the frame and its buffer.
+    if (ring_buffers_.find(sender) == ring_buffers_.end())
+      return;
+  }
+}
+
 // static
 mate::Handle<WebContents> WebContents::FromTabID(v8::Isolate* isolate,
     int tab_id) {
@@ -2779,6 +2837,22 @@ mate::Handle<WebContents> WebContents::FromTabID(v8::Isolate* isolate,
       extensions::TabHelper::GetTabById(tab_id));
 }
 
+// static
+v8::Local<v8::Value> WebContents::FromTabIDs(v8::Isolate* isolate,
+    const std::vector<int32_t>& tab_ids) {
+  std::vector<content::WebContents*> tabs =
+      extensions::TabHelper::GetTabsById(tab_ids);
+  v8::Local<v8::Array> result =
+      v8::Array::New(isolate, static_cast<int>(tabs.size()));
+  for (size_t i = 0; i < tabs.size(); ++i) {
+    if (tabs[i])
+      result->Set(i, CreateFrom(isolate, tabs[i]).ToV8());
+    else
+      result->Set(i, v8::Null(isolate));
+  }
+  return result;
+}
+
 void WebContents::OnTabCreated(const mate::Dictionary& options,
     base::Callback<void(content::WebContents*)> callback,
     content::WebContents* tab) {
@@ -3010,6 +3084,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("create", &WebContents::Create);
   dict.SetMethod("createTab", &WebContents::CreateTab);
   dict.SetMethod("fromTabID", &WebContents::FromTabID);
+  dict.SetMethod("fromTabIDs", &WebContents::FromTabIDs);
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
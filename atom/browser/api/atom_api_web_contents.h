@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 #define ATOM_BROWSER_API_ATOM_API_WEB_CONTENTS_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -85,6 +86,8 @@ class Dictionary;
 
 namespace atom {
 
+class SharedRingBuffer;
+
 struct SetSizeParams {
   SetSizeParams() {}
   ~SetSizeParams() {}
@@ -118,6 +121,9 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // Get the webcontents by tabId.
   static mate::Handle<WebContents> FromTabID(
     v8::Isolate* isolate, int tab_id);
+  // Get the webcontents of many tabs, null for the ids without a tab.
+  static v8::Local<v8::Value> FromTabIDs(
+    v8::Isolate* isolate, const std::vector<int32_t>& tab_ids);
 
   static void CreateTab(mate::Arguments* args);
 
@@ -463,6 +469,7 @@ class WebContents : public mate::TrackableObject<WebContents>,
   void BeforeUnloadFired(const base::TimeTicks& proceed_time) override;
   void RenderViewReady() override;
   void RenderViewDeleted(content::RenderViewHost*) override;
+  void RenderFrameDeleted(content::RenderFrameHost* render_frame_host) override;
   void RenderProcessGone(base::TerminationStatus status) override;
   void DocumentAvailableInMainFrame() override;
   void DocumentOnLoadCompletedInMainFrame() override;
@@ -553,6 +560,12 @@ class WebContents : public mate::TrackableObject<WebContents>,
                                const base::string16& channel,
                                const base::SharedMemoryHandle& shared_memory);
 
+  // Called when a frame shares its ring buffer and when it wrote to it.
+  void OnOpenRingBuffer(content::RenderFrameHost* sender,
+                        const base::SharedMemoryHandle& handle,
+                        uint32_t capacity);
+  void OnRingBufferSignal(content::RenderFrameHost* sender);
+
   v8::Global<v8::Value> session_;
   v8::Global<v8::Value> devtools_web_contents_;
   v8::Global<v8::Value> debugger_;
@@ -576,6 +589,11 @@ class WebContents : public mate::TrackableObject<WebContents>,
   base::WeakPtrFactory<WebContents> weak_ptr_factory_;
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
+
+  // The ring buffers frames send messages through.
+  std::map<content::RenderFrameHost*, std::unique_ptr<SharedRingBuffer>>
+      ring_buffers_;
+
   DISALLOW_COPY_AND_ASSIGN(WebContents);
 };
 
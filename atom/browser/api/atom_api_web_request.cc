@@ -64,6 +64,39 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+void SetRulesOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    std::unique_ptr<WebRequestRules> rules) {
+  auto delegate = static_cast<AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  delegate->SetRulesInIO(std::move(rules));
+}
+
+void SetBatchListenerOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    AtomNetworkDelegate::SimpleEvent type,
+    const URLPatterns& patterns,
+    uint32_t fields,
+    base::TimeDelta interval,
+    const AtomNetworkDelegate::BatchListener& listener) {
+  auto delegate = static_cast<AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  delegate->SetBatchListenerInIO(type, patterns, fields, interval, listener);
+}
+
+// Whether |filter| asks for the events to be delivered in batches.
+bool IsBatchFilter(v8::Isolate* isolate, v8::Local<v8::Value> filter) {
+  if (filter.IsEmpty() || !filter->IsObject() || filter->IsFunction())
+    return false;
+  mate::Dictionary dict(isolate, filter.As<v8::Object>());
+  v8::Local<v8::Value> interval;
+  return dict.Get("batchInterval", &interval) && !interval->IsUndefined();
+}
+
+}  // namespace
+
 WebRequest::WebRequest(v8::Isolate* isolate,
                        Profile* profile)
     : profile_(profile) {
@@ -149,6 +182,10 @@ void WebRequest::Fetch(mate::Arguments* args) {
 
 template<AtomNetworkDelegate::SimpleEvent type>
 void WebRequest::SetSimpleListener(mate::Arguments* args) {
+  if (IsBatchFilter(args->isolate(), args->PeekNext())) {
+    SetBatchListener(type, args);
+    return;
+  }
   SetListener<AtomNetworkDelegate::SimpleListener>(
       &AtomNetworkDelegate::SetSimpleListenerInIO, type, args);
 }
@@ -162,20 +199,21 @@ void WebRequest::SetResponseListener(mate::Arguments* args) {
 template<typename Listener, typename Method, typename Event>
 void WebRequest::SetListenerOnIOThread(
     const scoped_refptr<net::URLRequestContextGetter>& getter,
-    Method method, Event type, URLPatterns patterns, Listener listener) {
+    Method method, Event type, URLPatterns patterns, uint32_t fields,
+    Listener listener) {
   auto delegate = static_cast<AtomNetworkDelegate*>(
       getter->GetURLRequestContext()->network_delegate());
-  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
-                            base::Bind(method, base::Unretained(delegate),
-                            type, patterns, listener));
+  (delegate->*method)(type, patterns, fields, listener);
 }
 
 template<typename Listener, typename Method, typename Event>
 void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
-  // { urls }.
+  // { urls, fields }.
   URLPatterns patterns;
+  uint32_t fields = AtomNetworkDelegate::kAllFields;
   mate::Dictionary dict;
-  args->GetNext(&dict) && dict.Get("urls", &patterns);
+  if (args->GetNext(&dict) && !GetFilter(dict, args, &patterns, &fields))
+    return;
 
   // Function or null.
   v8::Local<v8::Value> value;
@@ -191,7 +229,84 @@ void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
         base::Unretained(this),
         scoped_refptr<net::URLRequestContextGetter>(
           profile_->GetRequestContext()),
-          method, type, patterns, listener));
+          method, type, patterns, fields, listener));
+}
+
+void WebRequest::SetBatchListener(AtomNetworkDelegate::SimpleEvent type,
+                                  mate::Arguments* args) {
+  // { urls, fields, batchInterval }.
+  URLPatterns patterns;
+  uint32_t fields = AtomNetworkDelegate::kAllFields;
+  mate::Dictionary dict;
+  if (!args->GetNext(&dict) || !GetFilter(dict, args, &patterns, &fields))
+    return;
+
+  int interval_ms = 0;
+  if (!dict.Get("batchInterval", &interval_ms) || interval_ms <= 0) {
+    args->ThrowError("batchInterval must be a positive Number");
+    return;
+  }
+
+  AtomNetworkDelegate::BatchListener listener;
+  if (!args->GetNext(&listener)) {
+    args->ThrowError("Must pass a Function");
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&SetBatchListenerOnIOThread,
+                 scoped_refptr<net::URLRequestContextGetter>(
+                     profile_->GetRequestContext()),
+                 type, patterns, fields,
+                 base::TimeDelta::FromMilliseconds(interval_ms), listener));
+}
+
+bool WebRequest::GetFilter(const mate::Dictionary& dict,
+                           mate::Arguments* args,
+                           URLPatterns* patterns,
+                           uint32_t* fields) {
+  dict.Get("urls", patterns);
+  std::vector<std::string> names;
+  if (dict.Get("fields", &names)) {
+    *fields = 0;
+    for (const auto& name : names) {
+      uint32_t field;
+      if (!AtomNetworkDelegate::GetDetailsField(name, &field)) {
+        args->ThrowError("Unknown details field: " + name);
+        return false;
+      }
+      *fields |= field;
+    }
+  }
+  return true;
+}
+
+void WebRequest::SetRules(mate::Arguments* args) {
+  // Array of rules, null or nothing removes them.
+  std::unique_ptr<WebRequestRules> rules;
+  base::ListValue list;
+  if (args->GetNext(&list)) {
+    std::string error;
+    if (!list.empty()) {
+      rules = WebRequestRules::Create(list, &error);
+      if (!rules) {
+        args->ThrowError(error);
+        return;
+      }
+    }
+  } else if (args->Length() > 0) {
+    v8::Local<v8::Value> value;
+    if (!args->GetNext(&value) || !value->IsNull()) {
+      args->ThrowError("Must pass null or an Array");
+      return;
+    }
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&SetRulesOnIOThread,
+                 scoped_refptr<net::URLRequestContextGetter>(
+                     profile_->GetRequestContext()),
+                 base::Passed(&rules)));
 }
 
 void WebRequest::HandleBehaviorChanged() {
@@ -238,6 +353,8 @@ void WebRequest::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<
                     AtomNetworkDelegate::kOnErrorOccurred>)
+      .SetMethod("setRules",
+                 &WebRequest::SetRules)
       .SetMethod("handleBehaviorChanged",
                  &WebRequest::HandleBehaviorChanged)
       .SetMethod("fetch",
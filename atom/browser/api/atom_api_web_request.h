@@ -9,6 +9,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/net/atom_network_delegate.h"
@@ -63,9 +64,18 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
   void SetListenerOnIOThread(
       const scoped_refptr<net::URLRequestContextGetter>& request_context,
       Method method, Event type,
-      URLPatterns patterns, Listener listener);
+      URLPatterns patterns, uint32_t fields, Listener listener);
   template<typename Listener, typename Method, typename Event>
   void SetListener(Method method, Event type, mate::Arguments* args);
+  void SetBatchListener(AtomNetworkDelegate::SimpleEvent type,
+                        mate::Arguments* args);
+  // Reads the |patterns| and |fields| of a listener filter, throws and
+  // returns false when it is invalid.
+  bool GetFilter(const mate::Dictionary& dict,
+                 mate::Arguments* args,
+                 URLPatterns* patterns,
+                 uint32_t* fields);
+  void SetRules(mate::Arguments* args);
 
  private:
   Profile* profile_;
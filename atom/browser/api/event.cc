@@ -4,6 +4,11 @@
 
 #include "atom/browser/api/event.h"
 
+#include <stdlib.h>
+
+#include <utility>
+#include <vector>
+
 #include "atom/common/api/api_messages.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "content/public/browser/render_frame_host.h"
@@ -49,7 +54,8 @@ void Event::PreventDefault(v8::Isolate* isolate) {
 }
 
 bool Event::SendReply(const base::string16& json) {
-  if (message_ == nullptr || sender_ == nullptr)
+  if (message_ == nullptr || sender_ == nullptr ||
+      message_->type() != AtomViewHostMsg_Message_Sync::ID)
     return false;
 
   AtomViewHostMsg_Message_Sync::WriteReplyParams(message_, json);
@@ -59,6 +65,31 @@ bool Event::SendReply(const base::string16& json) {
   return success;
 }
 
+bool Event::SendSerializedReply(v8::Isolate* isolate,
+                                v8::Local<v8::Value> value) {
+  if (message_ == nullptr || sender_ == nullptr ||
+      message_->type() != AtomViewHostMsg_Message_Sync_Serialized::ID)
+    return false;
+
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(isolate->GetCurrentContext(), value)
+          .FromMaybe(false)) {
+    // error will be thrown by serializer, the message can still be replied
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buf = serializer.Release();
+  std::vector<uint8_t> data(buf.first, buf.first + buf.second);
+  free(buf.first);
+
+  AtomViewHostMsg_Message_Sync_Serialized::WriteReplyParams(message_, data);
+  bool success = sender_->Send(message_);
+  message_ = nullptr;
+  sender_ = nullptr;
+  return success;
+}
+
 // static
 Handle<Event> Event::Create(v8::Isolate* isolate) {
   return mate::CreateHandle(isolate, new Event(isolate));
@@ -70,7 +101,8 @@ void Event::BuildPrototype(
   prototype->SetClassName(mate::StringToV8(isolate, "Event"));
   mate::ObjectTemplateBuilder(isolate, prototype->PrototypeTemplate())
       .SetMethod("preventDefault", &Event::PreventDefault)
-      .SetMethod("sendReply", &Event::SendReply);
+      .SetMethod("sendReply", &Event::SendReply)
+      .SetMethod("sendSerializedReply", &Event::SendSerializedReply);
 }
 
 }  // namespace mate
@@ -33,6 +33,10 @@ class Event : public Wrappable<Event>,
   // event.sendReply(json), used for replying synchronous message.
   bool SendReply(const base::string16& json);
 
+  // event.sendSerializedReply(value), replies to a synchronous message sent
+  // with sendSyncSerialized with |value| in the structured clone format.
+  bool SendSerializedReply(v8::Isolate* isolate, v8::Local<v8::Value> value);
+
  protected:
   explicit Event(v8::Isolate* isolate);
   ~Event() override;
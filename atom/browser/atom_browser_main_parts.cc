@@ -15,6 +15,8 @@
 #include "atom/browser/browser_context_keyed_service_factories.h"
 #include "atom/browser/javascript_environment.h"
 #include "atom/common/api/atom_bindings.h"
+#include "atom/common/asar/archive_registry.h"
+#include "atom/common/asar/extraction_cache.h"
 #include "atom/common/node_bindings.h"
 #include "atom/common/node_includes.h"
 #include "base/allocator/allocator_extension.h"
@@ -24,6 +26,7 @@
 #include "base/memory/memory_pressure_monitor.h"
 #include "base/path_service.h"
 #include "base/profiler/stack_sampling_profiler.h"
+#include "base/task_scheduler/post_task.h"
 #include "base/threading/thread_task_runner_handle.h"
 #include "base/time/default_tick_clock.h"
 #include "base/trace_event/trace_event.h"
@@ -248,6 +251,7 @@ void AtomBrowserMainParts::OnMemoryPressure(
     return;
 
   base::allocator::ReleaseFreeMemory();
+  asar::ArchiveRegistry::GetInstance()->EvictIdle(base::TimeDelta());
 
   if (js_env_.get() && js_env_->isolate()) {
     js_env_->isolate()->LowMemoryNotification();
@@ -256,6 +260,7 @@ void AtomBrowserMainParts::OnMemoryPressure(
 
 void AtomBrowserMainParts::IdleHandler() {
   base::allocator::ReleaseFreeMemory();
+  asar::ArchiveRegistry::GetInstance()->EvictExpired();
 }
 
 #if defined(OS_WIN)
@@ -321,6 +326,11 @@ void AtomBrowserMainParts::PreMainMessageLoopRun() {
   if (PathService::Get(chrome::DIR_USER_DATA, &user_data))
     base::CreateDirectoryAndGetError(user_data, nullptr);
 
+  // Drop the files extracted from archives that were deleted since.
+  base::PostTaskWithTraits(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::BACKGROUND},
+      base::Bind(&asar::SweepExtractionCache));
+
   // PreProfileInit
   EnsureBrowserContextKeyedServiceFactoriesBuilt();
   auto command_line = base::CommandLine::ForCurrentProcess();
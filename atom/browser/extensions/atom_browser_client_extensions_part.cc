@@ -4,9 +4,9 @@
 
 #include "atom/browser/extensions/atom_browser_client_extensions_part.h"
 
-#include <map>
 #include <set>
 
+#include "atom/browser/extensions/content_settings_broadcaster.h"
 #include "atom/common/api/api_messages.h"
 #include "base/command_line.h"
 #include "brave/browser/api/brave_api_extension.h"
@@ -17,10 +17,8 @@
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/extensions/extension_process_policy.h"
 #include "chrome/common/pref_names.h"
-#include "components/prefs/pref_change_registrar.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
-#include "components/user_prefs/user_prefs.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/public/browser/browser_url_handler.h"
 #include "content/public/browser/render_process_host.h"
@@ -89,8 +87,6 @@ RenderProcessHostPrivilege GetProcessPrivilege(
   return PRIV_EXTENSION;
 }
 
-static std::map<int, void*> render_process_hosts_;
-
 }  // namespace
 
 AtomBrowserClientExtensionsPart::AtomBrowserClientExtensionsPart() {
@@ -326,14 +322,7 @@ void AtomBrowserClientExtensionsPart::RenderProcessWillLaunch(
        id, context, host->GetStoragePartition()->GetServiceWorkerContext()));
   }
 
-  auto user_prefs_registrar = context->user_prefs_change_registrar();
-  if (!user_prefs_registrar->IsObserved("content_settings")) {
-    user_prefs_registrar->Add(
-        "content_settings",
-        base::Bind(&AtomBrowserClientExtensionsPart::UpdateContentSettings,
-                   base::Unretained(this)));
-  }
-  UpdateContentSettingsForHost(host->GetID());
+  ContentSettingsBroadcaster::FromProfile(context)->AddProcess(host);
 }
 
 // static
@@ -370,29 +359,6 @@ GURL AtomBrowserClientExtensionsPart::GetEffectiveURL(
   return extension->GetResourceURL(url.path());
 }
 
-void AtomBrowserClientExtensionsPart::UpdateContentSettingsForHost(
-  int render_process_id) {
-  auto host = content::RenderProcessHost::FromID(render_process_id);
-  if (!host)
-    return;
-
-  auto context =
-      static_cast<atom::AtomBrowserContext*>(host->GetBrowserContext());
-  auto user_prefs = user_prefs::UserPrefs::Get(context);
-  const base::DictionaryValue* content_settings =
-    user_prefs->GetDictionary("content_settings");
-  host->Send(new AtomMsg_UpdateContentSettings(*content_settings));
-}
-
-void AtomBrowserClientExtensionsPart::UpdateContentSettings() {
-  for (std::map<int, void*>::iterator
-      it = render_process_hosts_.begin();
-      it != render_process_hosts_.end();
-      ++it) {
-    UpdateContentSettingsForHost(it->first);
-  }
-}
-
 void AtomBrowserClientExtensionsPart::SiteInstanceGotProcess(
     SiteInstance* site_instance) {
   BrowserContext* context = site_instance->GetProcess()->GetBrowserContext();
@@ -400,8 +366,6 @@ void AtomBrowserClientExtensionsPart::SiteInstanceGotProcess(
   if (!registry)
     return;
 
-  render_process_hosts_[site_instance->GetProcess()->GetID()] = nullptr;
-
   const Extension* extension =
       registry->enabled_extensions().GetExtensionOrAppByURL(
           site_instance->GetSiteURL());
@@ -426,9 +390,6 @@ void AtomBrowserClientExtensionsPart::SiteInstanceDeleting(
   if (!registry)
     return;
 
-  if (render_process_hosts_[site_instance->GetProcess()->GetID()])
-    render_process_hosts_.erase(site_instance->GetProcess()->GetID());
-
   const Extension* extension =
       registry->enabled_extensions().GetExtensionOrAppByURL(
           site_instance->GetSiteURL());
@@ -0,0 +1,139 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/extensions/content_settings_broadcaster.h"
+
+#include "atom/common/api/api_messages.h"
+#include "base/bind.h"
+#include "base/memory/ptr_util.h"
+#include "base/values.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/pref_service.h"
+#include "components/user_prefs/user_prefs.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace extensions {
+
+namespace {
+
+const char kContentSettingsPref[] = "content_settings";
+
+const void* const kContentSettingsBroadcasterKey =
+    &kContentSettingsBroadcasterKey;
+
+// How long pref changes are collected before they are sent.
+const int kFlushDelayMs = 50;
+
+}  // namespace
+
+// static
+ContentSettingsBroadcaster* ContentSettingsBroadcaster::FromProfile(
+    Profile* profile) {
+  auto broadcaster = static_cast<ContentSettingsBroadcaster*>(
+      profile->GetUserData(kContentSettingsBroadcasterKey));
+  if (!broadcaster) {
+    broadcaster = new ContentSettingsBroadcaster(profile);
+    profile->SetUserData(kContentSettingsBroadcasterKey,
+                         base::WrapUnique(broadcaster));
+  }
+  return broadcaster;
+}
+
+ContentSettingsBroadcaster::ContentSettingsBroadcaster(Profile* profile)
+    : profile_(profile),
+      content_settings_(GetContentSettings()->CreateDeepCopy()),
+      version_(1),
+      flush_pending_(false),
+      weak_factory_(this) {
+  auto user_prefs_registrar = profile_->user_prefs_change_registrar();
+  if (!user_prefs_registrar->IsObserved(kContentSettingsPref)) {
+    user_prefs_registrar->Add(
+        kContentSettingsPref,
+        base::Bind(&ContentSettingsBroadcaster::OnContentSettingsChanged,
+                   weak_factory_.GetWeakPtr()));
+  }
+}
+
+ContentSettingsBroadcaster::~ContentSettingsBroadcaster() {
+}
+
+void ContentSettingsBroadcaster::AddProcess(content::RenderProcessHost* host) {
+  // Don't hand out settings the other processes don't have yet.
+  if (flush_pending_)
+    Flush();
+
+  host->Send(new AtomMsg_UpdateContentSettings(*content_settings_, version_));
+  processes_[host->GetID()] = version_;
+}
+
+void ContentSettingsBroadcaster::OnContentSettingsChanged() {
+  if (flush_pending_)
+    return;
+  flush_pending_ = true;
+  BrowserThread::PostDelayedTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&ContentSettingsBroadcaster::Flush,
+                 weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kFlushDelayMs));
+}
+
+void ContentSettingsBroadcaster::Flush() {
+  if (!flush_pending_)
+    return;
+  flush_pending_ = false;
+
+  // Changed content types are replaced, removed ones are set to null.
+  const base::DictionaryValue* content_settings = GetContentSettings();
+  base::DictionaryValue changes;
+  for (base::DictionaryValue::Iterator it(*content_settings); !it.IsAtEnd();
+       it.Advance()) {
+    const base::Value* old_value = nullptr;
+    if (!content_settings_->GetWithoutPathExpansion(it.key(), &old_value) ||
+        !old_value->Equals(&it.value())) {
+      changes.SetWithoutPathExpansion(it.key(), it.value().CreateDeepCopy());
+    }
+  }
+  for (base::DictionaryValue::Iterator it(*content_settings_); !it.IsAtEnd();
+       it.Advance()) {
+    if (!content_settings->HasKey(it.key()))
+      changes.SetWithoutPathExpansion(it.key(),
+                                      base::MakeUnique<base::Value>());
+  }
+  if (changes.empty())
+    return;
+
+  int base_version = version_++;
+  content_settings_ = content_settings->CreateDeepCopy();
+
+  for (auto it = processes_.begin(); it != processes_.end();) {
+    content::RenderProcessHost* host =
+        content::RenderProcessHost::FromID(it->first);
+    if (!host) {
+      it = processes_.erase(it);
+      continue;
+    }
+    // A process that missed an update needs everything.
+    if (it->second == base_version) {
+      host->Send(new AtomMsg_UpdateContentSettingsDelta(
+          base_version, version_, changes));
+    } else {
+      host->Send(new AtomMsg_UpdateContentSettings(*content_settings_,
+                                                   version_));
+    }
+    it->second = version_;
+    ++it;
+  }
+}
+
+const base::DictionaryValue*
+ContentSettingsBroadcaster::GetContentSettings() const {
+  return user_prefs::UserPrefs::Get(profile_)->GetDictionary(
+      kContentSettingsPref);
+}
+
+}  // namespace extensions
@@ -0,0 +1,68 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_EXTENSIONS_CONTENT_SETTINGS_BROADCASTER_H_
+#define ATOM_BROWSER_EXTENSIONS_CONTENT_SETTINGS_BROADCASTER_H_
+
+#include <map>
+#include <memory>
+
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/supports_user_data.h"
+
+class Profile;
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace content {
+class RenderProcessHost;
+}
+
+namespace extensions {
+
+// Keeps the content settings of the render processes of a profile in sync
+// with its "content_settings" pref.
+//
+// Every broadcast bumps a version. A process gets the whole dictionary when
+// it launches, after that only the content types that changed are sent as
+// long as it is at the previous version. Pref changes made in quick
+// succession are coalesced into one broadcast.
+class ContentSettingsBroadcaster : public base::SupportsUserData::Data {
+ public:
+  static ContentSettingsBroadcaster* FromProfile(Profile* profile);
+
+  ~ContentSettingsBroadcaster() override;
+
+  // Sends the content settings to |host| and keeps it up to date.
+  void AddProcess(content::RenderProcessHost* host);
+
+ private:
+  explicit ContentSettingsBroadcaster(Profile* profile);
+
+  void OnContentSettingsChanged();
+  void Flush();
+
+  const base::DictionaryValue* GetContentSettings() const;
+
+  Profile* profile_;
+
+  // The content settings the processes have been sent, at |version_|.
+  std::unique_ptr<base::DictionaryValue> content_settings_;
+  int version_;
+  bool flush_pending_;
+
+  // Render process id to the version it has.
+  std::map<int, int> processes_;
+
+  base::WeakPtrFactory<ContentSettingsBroadcaster> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsBroadcaster);
+};
+
+}  // namespace extensions
+
+#endif  // ATOM_BROWSER_EXTENSIONS_CONTENT_SETTINGS_BROADCASTER_H_
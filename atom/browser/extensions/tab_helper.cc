@@ -4,10 +4,11 @@
 
 #include "atom/browser/extensions/tab_helper.h"
 
-#include <map>
+#include <vector>
 #include <utility>
 #include "atom/browser/extensions/api/atom_extensions_api_client.h"
 #include "atom/browser/extensions/atom_extension_web_contents_observer.h"
+#include "atom/browser/extensions/tab_registry.h"
 #include "atom/browser/native_window.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -29,7 +30,6 @@
 #include "content/public/browser/navigation_entry.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
-#include "content/public/browser/render_view_host.h"
 #include "content/public/browser/web_contents.h"
 #include "extensions/browser/component_extension_resource_manager.h"
 #include "extensions/browser/extension_api_frame_id_map.h"
@@ -65,8 +65,6 @@ const char kPinnedKey[] = "pinned";
 const char kSelectedKey[] = "selected";
 }  // namespace keys
 
-static std::map<int32_t, std::pair<int, int>> render_view_map_;
-
 namespace extensions {
 
 namespace {
@@ -93,9 +91,9 @@ TabHelper::TabHelper(content::WebContents* contents)
   SessionTabHelper::CreateForWebContents(contents);
   SetWindowId(-1);
 
-  RenderViewCreated(contents->GetRenderViewHost());
+  TabRegistry::GetInstance()->AddTab(session_id(), contents);
   contents->ForEachFrame(
-      base::Bind(&TabHelper::SetTabId, base::Unretained(this)));
+      base::Bind(&TabHelper::RenderFrameCreated, base::Unretained(this)));
 
   AtomExtensionWebContentsObserver::CreateForWebContents(contents);
   BrowserList::AddObserver(this);
@@ -389,6 +387,8 @@ void TabHelper::WasShown() {
       helper->RemoveRestoreHelper();
     }
 
+    static_cast<resource_coordinator::GuestTabManager*>(GetTabManager())->
+        OnTabRestoreStarted(web_contents());
     web_contents()->GetController().Reload(content::ReloadType::NORMAL, true);
   }
 }
@@ -541,14 +541,9 @@ void TabHelper::SetOpener(int opener_tab_id) {
   opener_tab_id_ = opener_tab_id;
 }
 
-void TabHelper::RenderViewCreated(content::RenderViewHost* render_view_host) {
-  render_view_map_[session_id()] = std::make_pair(
-      render_view_host->GetProcess()->GetID(),
-      render_view_host->GetRoutingID());
-}
-
 void TabHelper::RenderFrameCreated(content::RenderFrameHost* host) {
   SetTabId(host);
+  TabRegistry::GetInstance()->AddFrame(session_id(), host);
   // Look up the extension API frame ID to force the mapping to be cached.
   // This is needed so that cached information is available for tabId in the
   // filtering callbacks.
@@ -559,7 +554,15 @@ void TabHelper::WebContentsDestroyed() {
   if (browser())
     SetBrowser(nullptr);
 
-  render_view_map_.erase(session_id());
+  TabRegistry::GetInstance()->RemoveTab(session_id(), web_contents());
+}
+
+void TabHelper::RenderFrameDeleted(content::RenderFrameHost* host) {
+  TabRegistry::GetInstance()->RemoveRenderFrame(host);
+}
+
+void TabHelper::FrameDeleted(content::RenderFrameHost* host) {
+  TabRegistry::GetInstance()->RemoveFrameTreeNode(host->GetFrameTreeNodeId());
 }
 
 void TabHelper::SetTabId(content::RenderFrameHost* render_frame_host) {
@@ -732,14 +735,18 @@ int TabHelper::get_index() const {
 
 // static
 content::WebContents* TabHelper::GetTabById(int32_t tab_id) {
-  content::RenderViewHost* rvh =
-      content::RenderViewHost::FromID(render_view_map_[tab_id].first,
-                                      render_view_map_[tab_id].second);
-  if (rvh) {
-    return content::WebContents::FromRenderViewHost(rvh);
-  } else {
-    return NULL;
-  }
+  return TabRegistry::GetInstance()->GetTab(tab_id);
+}
+
+// static
+std::vector<content::WebContents*> TabHelper::GetTabsById(
+    const std::vector<int32_t>& tab_ids) {
+  TabRegistry* registry = TabRegistry::GetInstance();
+  std::vector<content::WebContents*> tabs;
+  tabs.reserve(tab_ids.size());
+  for (int32_t tab_id : tab_ids)
+    tabs.push_back(registry->GetTab(tab_id));
+  return tabs;
 }
 
 // static
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "atom/browser/native_window_observer.h"
 #include "base/macros.h"
@@ -138,6 +139,9 @@ class TabHelper : public content::WebContentsObserver,
   static content::WebContents* GetTabById(int tab_id,
                          content::BrowserContext* browser_context);
   static content::WebContents* GetTabById(int32_t tab_id);
+  // Looks up many tabs at once, nullptr for the ids without a tab.
+  static std::vector<content::WebContents*> GetTabsById(
+      const std::vector<int32_t>& tab_ids);
 
   static int GetTabStripIndex(int window_id, int index);
 
@@ -177,8 +181,9 @@ class TabHelper : public content::WebContentsObserver,
       std::unique_ptr<std::string> code_string);
 
   // content::WebContentsObserver overrides.
-  void RenderViewCreated(content::RenderViewHost* render_view_host) override;
   void RenderFrameCreated(content::RenderFrameHost* host) override;
+  void RenderFrameDeleted(content::RenderFrameHost* host) override;
+  void FrameDeleted(content::RenderFrameHost* host) override;
   void WebContentsDestroyed() override;
   void DidCloneToNewWebContents(
       content::WebContents* old_web_contents,
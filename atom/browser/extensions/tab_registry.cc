@@ -0,0 +1,153 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/extensions/tab_registry.h"
+
+#include "base/bind.h"
+#include "base/lazy_instance.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+
+using content::BrowserThread;
+
+namespace extensions {
+
+namespace {
+
+// Read from other threads during shutdown.
+base::LazyInstance<TabRegistry>::Leaky g_tab_registry =
+    LAZY_INSTANCE_INITIALIZER;
+
+uint64_t GetRenderFrameKey(int render_process_id, int render_frame_id) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(render_process_id))
+      << 32) | static_cast<uint32_t>(render_frame_id);
+}
+
+uint64_t GetRenderFrameKey(content::RenderFrameHost* host) {
+  return GetRenderFrameKey(host->GetProcess()->GetID(), host->GetRoutingID());
+}
+
+}  // namespace
+
+TabRegistry::Snapshot::Snapshot(const FrameTreeNodeMap& frame_tree_nodes,
+                                const RenderFrameMap& render_frames)
+    : frame_tree_nodes(frame_tree_nodes),
+      render_frames(render_frames) {
+}
+
+TabRegistry::Snapshot::~Snapshot() {
+}
+
+TabRegistry::TabRegistry()
+    : publish_pending_(false),
+      snapshot_(new Snapshot(FrameTreeNodeMap(), RenderFrameMap())) {
+}
+
+TabRegistry::~TabRegistry() {
+}
+
+// static
+TabRegistry* TabRegistry::GetInstance() {
+  return g_tab_registry.Pointer();
+}
+
+void TabRegistry::AddTab(int32_t tab_id, content::WebContents* contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  tabs_[tab_id] = contents;
+}
+
+void TabRegistry::RemoveTab(int32_t tab_id, content::WebContents* contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = tabs_.find(tab_id);
+  if (it == tabs_.end() || it->second != contents)
+    return;
+  tabs_.erase(it);
+
+  for (auto frame = frame_tree_nodes_.begin();
+       frame != frame_tree_nodes_.end();) {
+    if (frame->second == tab_id)
+      frame = frame_tree_nodes_.erase(frame);
+    else
+      ++frame;
+  }
+  for (auto frame = render_frames_.begin(); frame != render_frames_.end();) {
+    if (frame->second == tab_id)
+      frame = render_frames_.erase(frame);
+    else
+      ++frame;
+  }
+  SchedulePublish();
+}
+
+void TabRegistry::AddFrame(int32_t tab_id, content::RenderFrameHost* host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  frame_tree_nodes_[host->GetFrameTreeNodeId()] = tab_id;
+  render_frames_[GetRenderFrameKey(host)] = tab_id;
+  // The frame's first requests may be looked up before the current task is
+  // done, so additions are published right away.
+  Publish();
+}
+
+void TabRegistry::RemoveRenderFrame(content::RenderFrameHost* host) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (render_frames_.erase(GetRenderFrameKey(host)))
+    SchedulePublish();
+}
+
+void TabRegistry::RemoveFrameTreeNode(int frame_tree_node_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (frame_tree_nodes_.erase(frame_tree_node_id))
+    SchedulePublish();
+}
+
+content::WebContents* TabRegistry::GetTab(int32_t tab_id) const {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  auto it = tabs_.find(tab_id);
+  return it == tabs_.end() ? nullptr : it->second;
+}
+
+int32_t TabRegistry::GetTabIdForFrame(int frame_tree_node_id,
+                                      int render_process_id,
+                                      int render_frame_id) const {
+  scoped_refptr<const Snapshot> snapshot;
+  {
+    base::AutoLock auto_lock(lock_);
+    snapshot = snapshot_;
+  }
+
+  auto node = snapshot->frame_tree_nodes.find(frame_tree_node_id);
+  if (node != snapshot->frame_tree_nodes.end())
+    return node->second;
+  auto frame = snapshot->render_frames.find(
+      GetRenderFrameKey(render_process_id, render_frame_id));
+  if (frame != snapshot->render_frames.end())
+    return frame->second;
+  return -1;
+}
+
+void TabRegistry::SchedulePublish() {
+  if (publish_pending_)
+    return;
+  publish_pending_ = true;
+  // The registry is leaked, so it outlives the task.
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&TabRegistry::PublishPending, base::Unretained(this)));
+}
+
+void TabRegistry::PublishPending() {
+  if (publish_pending_)
+    Publish();
+}
+
+void TabRegistry::Publish() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  publish_pending_ = false;
+  scoped_refptr<const Snapshot> snapshot(
+      new Snapshot(frame_tree_nodes_, render_frames_));
+  base::AutoLock auto_lock(lock_);
+  snapshot_.swap(snapshot);
+}
+
+}  // namespace extensions
@@ -0,0 +1,91 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_EXTENSIONS_TAB_REGISTRY_H_
+#define ATOM_BROWSER_EXTENSIONS_TAB_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace content {
+class RenderFrameHost;
+class WebContents;
+}
+
+namespace extensions {
+
+// Indexes the tabs by their id, and their frames by frame tree node id and
+// render frame id.
+//
+// Tabs and frames are registered on the UI thread by TabHelper. The frame
+// indexes are also published as immutable snapshots, so the tab of a frame
+// can be looked up from any thread without going through the UI thread. New
+// frames are published right away, while removals made in a task are
+// published together once it is done.
+class TabRegistry {
+ public:
+  TabRegistry();
+  ~TabRegistry();
+
+  static TabRegistry* GetInstance();
+
+  // UI thread.
+  void AddTab(int32_t tab_id, content::WebContents* contents);
+  void RemoveTab(int32_t tab_id, content::WebContents* contents);
+  void AddFrame(int32_t tab_id, content::RenderFrameHost* host);
+  void RemoveRenderFrame(content::RenderFrameHost* host);
+  void RemoveFrameTreeNode(int frame_tree_node_id);
+  content::WebContents* GetTab(int32_t tab_id) const;
+
+  // Any thread, returns -1 if the frame is not in a tab. The frame tree node
+  // id is tried first.
+  int32_t GetTabIdForFrame(int frame_tree_node_id,
+                           int render_process_id,
+                           int render_frame_id) const;
+
+ private:
+  // Frame tree node id => tab id.
+  using FrameTreeNodeMap = std::unordered_map<int, int32_t>;
+  // Render process id and render frame id => tab id.
+  using RenderFrameMap = std::unordered_map<uint64_t, int32_t>;
+
+  struct Snapshot : public base::RefCountedThreadSafe<Snapshot> {
+    Snapshot(const FrameTreeNodeMap& frame_tree_nodes,
+             const RenderFrameMap& render_frames);
+
+    const FrameTreeNodeMap frame_tree_nodes;
+    const RenderFrameMap render_frames;
+
+   private:
+    friend class base::RefCountedThreadSafe<Snapshot>;
+    ~Snapshot();
+  };
+
+  // Publishes the changes once the current task is done.
+  void SchedulePublish();
+  // Publishes the scheduled changes unless they already were.
+  void PublishPending();
+  // Replaces the snapshot read by other threads.
+  void Publish();
+
+  std::unordered_map<int32_t, content::WebContents*> tabs_;
+  FrameTreeNodeMap frame_tree_nodes_;
+  RenderFrameMap render_frames_;
+  bool publish_pending_;
+
+  mutable base::Lock lock_;
+  // Guarded by |lock_|, never changed once published.
+  scoped_refptr<const Snapshot> snapshot_;
+
+  DISALLOW_COPY_AND_ASSIGN(TabRegistry);
+};
+
+}  // namespace extensions
+
+#endif  // ATOM_BROWSER_EXTENSIONS_TAB_REGISTRY_H_
@@ -17,7 +17,10 @@ ExternalProcessImporterClient::ExternalProcessImporterClient(
     InProcessImporterBridge* bridge)
     : ::ExternalProcessImporterClient(
           importer_host, source_profile, items, bridge),
+      total_history_rows_count_(0),
+      history_rows_count_(0),
       total_cookies_count_(0),
+      cookies_count_(0),
       bridge_(bridge),
       cancelled_(false) {}
 
@@ -29,23 +32,69 @@ void ExternalProcessImporterClient::Cancel() {
   ::ExternalProcessImporterClient::Cancel();
 }
 
+void ExternalProcessImporterClient::OnImportItemFinished(
+    importer::ImportItem import_item) {
+  if (cancelled_)
+    return;
+
+  // The totals are counted before the rows are read and include rows the
+  // importer skips, so the last progress update carries the real count.
+  if (import_item == importer::HISTORY)
+    bridge_->NotifyItemProgress(importer::HISTORY, history_rows_count_,
+                                history_rows_count_);
+  else if (import_item == importer::COOKIES)
+    bridge_->NotifyItemProgress(importer::COOKIES, cookies_count_,
+                                cookies_count_);
+
+  ::ExternalProcessImporterClient::OnImportItemFinished(import_item);
+}
+
+// Unlike the base class, groups are handed to the bridge as they arrive
+// instead of being collected until the whole item has been received. Every
+// group is dispatched in its own task, so the UI thread stays responsive
+// while a large profile is imported.
+void ExternalProcessImporterClient::OnHistoryImportStart(
+    uint32_t total_history_rows_count) {
+  if (cancelled_)
+    return;
+
+  total_history_rows_count_ = total_history_rows_count;
+  history_rows_count_ = 0;
+  bridge_->NotifyItemProgress(importer::HISTORY, 0, total_history_rows_count_);
+}
+
+void ExternalProcessImporterClient::OnHistoryImportGroup(
+    const std::vector<ImporterURLRow>& history_rows_group,
+    int visit_source) {
+  if (cancelled_)
+    return;
+
+  bridge_->SetHistoryItems(history_rows_group,
+                           static_cast<importer::VisitSource>(visit_source));
+  history_rows_count_ += static_cast<uint32_t>(history_rows_group.size());
+  bridge_->NotifyItemProgress(importer::HISTORY, history_rows_count_,
+                              total_history_rows_count_);
+}
+
 void ExternalProcessImporterClient::OnCookiesImportStart(
     uint32_t total_cookies_count) {
   if (cancelled_)
     return;
 
   total_cookies_count_ = total_cookies_count;
-  cookies_.reserve(total_cookies_count);
+  cookies_count_ = 0;
+  bridge_->NotifyItemProgress(importer::COOKIES, 0, total_cookies_count_);
 }
+
 void ExternalProcessImporterClient::OnCookiesImportGroup(
     const std::vector<ImportedCookieEntry>& cookies_group) {
   if (cancelled_)
     return;
 
-  cookies_.insert(cookies_.end(), cookies_group.begin(),
-                  cookies_group.end());
-  if (cookies_.size() >= total_cookies_count_)
-    bridge_->SetCookies(cookies_);
+  bridge_->SetCookies(cookies_group);
+  cookies_count_ += static_cast<uint32_t>(cookies_group.size());
+  bridge_->NotifyItemProgress(importer::COOKIES, cookies_count_,
+                              total_cookies_count_);
 }
 
 ExternalProcessImporterClient::~ExternalProcessImporterClient() {}
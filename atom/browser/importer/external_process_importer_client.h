@@ -26,6 +26,11 @@ class ExternalProcessImporterClient : public ::ExternalProcessImporterClient {
   // Called by the ExternalProcessImporterHost on import cancel.
   void Cancel();
 
+  void OnImportItemFinished(importer::ImportItem import_item) override;
+  void OnHistoryImportStart(uint32_t total_history_rows_count) override;
+  void OnHistoryImportGroup(
+      const std::vector<ImporterURLRow>& history_rows_group,
+      int visit_source) override;
   void OnCookiesImportStart(
       uint32_t total_cookies_count) override;
   void OnCookiesImportGroup(
@@ -35,13 +40,15 @@ class ExternalProcessImporterClient : public ::ExternalProcessImporterClient {
  private:
   ~ExternalProcessImporterClient() override;
 
-  // Total number of cookies to import.
-  size_t total_cookies_count_;
+  // Total number of history rows and cookies to import, and how many of them
+  // have been handed to the bridge so far.
+  uint32_t total_history_rows_count_;
+  uint32_t history_rows_count_;
+  uint32_t total_cookies_count_;
+  uint32_t cookies_count_;
 
   scoped_refptr<InProcessImporterBridge> bridge_;
 
-  std::vector<ImportedCookieEntry> cookies_;
-
   // True if import process has been cancelled.
   bool cancelled_;
 
@@ -81,6 +81,12 @@ void InProcessImporterBridge::SetCookies(
   writer_->AddCookies(cookies);
 }
 
+void InProcessImporterBridge::NotifyItemProgress(importer::ImportItem item,
+                                                 uint32_t imported_count,
+                                                 uint32_t total_count) {
+  writer_->UpdateProgress(item, imported_count, total_count);
+}
+
 InProcessImporterBridge::~InProcessImporterBridge() {}
 
 }  // namespace atom
@@ -37,6 +37,12 @@ class InProcessImporterBridge : public ::InProcessImporterBridge {
 
   virtual void SetCookies(const std::vector<ImportedCookieEntry>& cookies);
 
+  // Reports that |imported_count| of |total_count| entries of |item| have
+  // been handed to the profile writer.
+  void NotifyItemProgress(importer::ImportItem item,
+                          uint32_t imported_count,
+                          uint32_t total_count);
+
  private:
   ~InProcessImporterBridge() override;
 
@@ -4,16 +4,18 @@
 
 #include "atom/browser/importer/profile_writer.h"
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_app.h"
 #include "atom/browser/api/atom_api_importer.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
-#include "base/base64.h"
+#include "base/hash.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/importer/imported_cookie_entry.h"
 #include "build/build_config.h"
@@ -128,17 +130,38 @@ void ProfileWriter::AddBookmarks(
 void ProfileWriter::AddFavicons(
     const favicon_base::FaviconUsageDataList& favicons) {
   if (importer_) {
+    // Many pages share an icon, so every distinct png is sent once as a
+    // buffer and the favicons refer to it by its index in |png_data|.
     base::ListValue imported_favicons;
+    base::ListValue png_data;
+    // Hash of a png to the data and index of the pngs with that hash.
+    std::multimap<uint32_t, std::pair<const std::vector<unsigned char>*, int>>
+        png_by_hash;
     for (const favicon_base::FaviconUsageData& favicon : favicons) {
       base::DictionaryValue* imported_favicon = new base::DictionaryValue();
       imported_favicon->SetString("favicon_url",
                                   favicon.favicon_url.possibly_invalid_spec());
-      std::string data_url;
-      data_url.insert(data_url.end(), favicon.png_data.begin(),
-                      favicon.png_data.end());
-      base::Base64Encode(data_url, &data_url);
-      data_url.insert(0, "data:image/png;base64,");
-      imported_favicon->SetString("png_data", data_url);
+      if (!favicon.png_data.empty()) {
+        const std::vector<unsigned char>& data = favicon.png_data;
+        uint32_t hash = base::Hash(
+            reinterpret_cast<const char*>(data.data()), data.size());
+        int index = -1;
+        auto range = png_by_hash.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+          if (*it->second.first == data) {
+            index = it->second.second;
+            break;
+          }
+        }
+        if (index == -1) {
+          index = static_cast<int>(png_data.GetSize());
+          png_by_hash.insert(
+              std::make_pair(hash, std::make_pair(&data, index)));
+          png_data.Append(base::Value::CreateWithCopiedBuffer(
+              reinterpret_cast<const char*>(data.data()), data.size()));
+        }
+        imported_favicon->SetInteger("png_index", index);
+      }
       std::set<GURL>::iterator it;
       auto urls = base::MakeUnique<base::ListValue>();
       for (it = favicon.urls.begin(); it != favicon.urls.end(); ++it) {
@@ -148,7 +171,7 @@ void ProfileWriter::AddFavicons(
       imported_favicons.Append(std::unique_ptr<base::DictionaryValue>(
                                   imported_favicon));
     }
-    importer_->Emit("add-favicons", imported_favicons);
+    importer_->Emit("add-favicons", imported_favicons, png_data);
   }
 }
 
@@ -198,6 +221,15 @@ void ProfileWriter::AddCookies(
   }
 }
 
+void ProfileWriter::UpdateProgress(importer::ImportItem item,
+                                   uint32_t imported_count,
+                                   uint32_t total_count) {
+  if (importer_) {
+    importer_->Emit("import-progress", (unsigned int) item, imported_count,
+                    total_count);
+  }
+}
+
 void ProfileWriter::Initialize(atom::api::Importer* importer) {
   importer_ = importer;
 }
@@ -10,6 +10,7 @@
 #include "base/macros.h"
 #include "build/build_config.h"
 #include "chrome/browser/importer/profile_writer.h"
+#include "chrome/common/importer/importer_data_types.h"
 
 struct ImportedCookieEntry;
 
@@ -44,6 +45,10 @@ class ProfileWriter : public ::ProfileWriter {
   void AddAutofillFormDataEntries(
       const std::vector<autofill::AutofillEntry>& autofill_entries) override;
   virtual void AddCookies(const std::vector<ImportedCookieEntry>& cookies);
+  // Emits the progress of an item that is imported in pages.
+  void UpdateProgress(importer::ImportItem item,
+                      uint32_t imported_count,
+                      uint32_t total_count);
   void Initialize(atom::api::Importer* importer);
 
  protected:
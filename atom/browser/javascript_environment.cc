@@ -20,6 +20,7 @@
 #include "brave/common/extensions/crash_reporter_bindings.h"
 #include "brave/common/extensions/crypto_bindings.h"
 #include "brave/common/extensions/file_bindings.h"
+#include "brave/common/extensions/module_loader_bindings.h"
 #include "brave/common/extensions/path_bindings.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "brave/common/extensions/url_bindings.h"
@@ -153,6 +154,10 @@ JavascriptEnvironment::JavascriptEnvironment()
     script_context_->module_system()->RegisterNativeHandler(
       "path", std::unique_ptr<extensions::NativeHandler>(
           new brave::PathBindings(script_context_.get(), &source_map_)));
+    script_context_->module_system()->RegisterNativeHandler(
+      "moduleLoader", std::unique_ptr<extensions::NativeHandler>(
+          new brave::ModuleLoaderBindings(script_context_.get(),
+                                          &source_map_)));
   }
 
   ModuleRegistry* registry = ModuleRegistry::From(context());
@@ -198,6 +203,9 @@ void JavascriptEnvironment::OnMessageLoopCreated() {
 }
 
 void JavascriptEnvironment::OnMessageLoopDestroying() {
+  // The environment is leaked on exit, write what is still pending while the
+  // file task runner runs.
+  brave::FileBindings::CommitPendingWrites();
   isolate_holder_->RemoveRunMicrotasksObserver();
 }
 
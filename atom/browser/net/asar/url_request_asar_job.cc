@@ -4,6 +4,8 @@
 
 #include "atom/browser/net/asar/url_request_asar_job.h"
 
+#include <string.h>
+
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,6 +18,7 @@
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "net/base/file_stream.h"
 #include "net/base/filename_util.h"
 #include "net/base/io_buffer.h"
@@ -40,6 +43,8 @@ void Initialize(
     std::shared_ptr<Archive>& archive,  // NOLINT
     base::FilePath* file_path,
     Archive::FileInfo* file_info,
+    base::StringPiece* mapped_contents,
+    bool* use_mapping,
     URLRequestAsarJob::JobType* type) {
   // Determine whether it is an asar file.
   base::FilePath asar_path, relative_path;
@@ -62,10 +67,25 @@ void Initialize(
     return;
   }
 
+  // Serve the bytes straight from the archive's mapping when possible, the
+  // file stream is only used as a fallback, e.g. when the archive has been
+  // truncated since it was mapped.
+  *use_mapping = archive->GetMappedContents(*file_info, mapped_contents);
+
   *file_path = relative_path;
   *type = URLRequestAsarJob::TYPE_ASAR;
 }
 
+// Copies |contents| out of the archive's mapping, which may fault pages in
+// from disk, so it runs on the file task runner. |archive| keeps the mapping
+// alive.
+int ReadMappedContents(std::shared_ptr<Archive> archive,
+                       base::StringPiece contents,
+                       scoped_refptr<net::IOBuffer> dest) {
+  memcpy(dest->data(), contents.data(), contents.size());
+  return static_cast<int>(contents.size());
+}
+
 }  // namespace
 
 URLRequestAsarJob::FileMetaInfo::FileMetaInfo()
@@ -81,6 +101,8 @@ URLRequestAsarJob::URLRequestAsarJob(
     const scoped_refptr<base::TaskRunner> file_task_runner)
     : net::URLRequestJob(request, network_delegate),
       type_(TYPE_ERROR),
+      use_mapping_(false),
+      mapped_position_(0),
       remaining_bytes_(0),
       seek_offset_(0),
       range_parse_result_(net::OK),
@@ -103,13 +125,16 @@ void URLRequestAsarJob::Start() {
   file_task_runner_->PostTaskAndReply(
       FROM_HERE,
       base::Bind(&Initialize,
-          full_path_, std::ref(archive_), &file_path_, &file_info_, &type_),
+          full_path_, std::ref(archive_), &file_path_, &file_info_,
+          &mapped_contents_, &use_mapping_, &type_),
       base::Bind(&URLRequestAsarJob::DidInitialize,
           weak_ptr_factory_.GetWeakPtr()));
 }
 
 void URLRequestAsarJob::DidInitialize() {
-  if (type_ == TYPE_ASAR) {
+  if (type_ == TYPE_ASAR && use_mapping_) {
+    DidOpen(net::OK);
+  } else if (type_ == TYPE_ASAR) {
     InitializeAsarJob();
     int flags = base::File::FLAG_OPEN |
                 base::File::FLAG_READ |
@@ -151,6 +176,20 @@ int URLRequestAsarJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
   if (!dest_size)
     return 0;
 
+  if (use_mapping_) {
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::Bind(&ReadMappedContents, archive_,
+                   mapped_contents_.substr(
+                       static_cast<size_t>(mapped_position_), dest_size),
+                   make_scoped_refptr(dest)),
+        base::Bind(&URLRequestAsarJob::DidRead,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   make_scoped_refptr(dest)));
+    mapped_position_ += dest_size;
+    return net::ERR_IO_PENDING;
+  }
+
   int rv = stream_->Read(dest,
                          dest_size,
                          base::Bind(&URLRequestAsarJob::DidRead,
@@ -193,6 +232,13 @@ bool URLRequestAsarJob::IsRedirectResponse(GURL* location,
 std::unique_ptr<net::SourceStream> URLRequestAsarJob::SetUpSourceStream() {
   std::unique_ptr<net::SourceStream> source =
     URLRequestJob::SetUpSourceStream();
+
+  // Compressed entries are inflated while they are streamed.
+  if (type_ == TYPE_ASAR && file_info_.encoding == Archive::ENCODING_GZIP) {
+    source = net::GzipSourceStream::Create(std::move(source),
+                                           net::SourceStream::TYPE_GZIP);
+  }
+
   if (!base::LowerCaseEqualsASCII(file_path_.Extension(), ".svgz"))
     return source;
 
@@ -288,9 +334,18 @@ void URLRequestAsarJob::DidOpen(int result) {
     return;
   }
 
+  // Compressed entries can't be seeked into, they are only served whole.
+  if (type_ == TYPE_ASAR && file_info_.encoding != Archive::ENCODING_NONE &&
+      byte_range_.IsValid()) {
+    NotifyStartError(
+        net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                              net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+    return;
+  }
+
   int64_t file_size, read_offset;
   if (type_ == TYPE_ASAR) {
-    file_size = file_info_.size;
+    file_size = file_info_.stored_size();
     read_offset = file_info_.offset;
   } else {
     file_size = meta_info_.file_size;
@@ -308,6 +363,12 @@ void URLRequestAsarJob::DidOpen(int result) {
                      byte_range_.first_byte_position() + 1;
   seek_offset_ = byte_range_.first_byte_position() + read_offset;
 
+  if (use_mapping_) {
+    mapped_position_ = byte_range_.first_byte_position();
+    DidSeek(seek_offset_);
+    return;
+  }
+
   if (remaining_bytes_ > 0 && seek_offset_ != 0) {
     int rv = stream_->Seek(seek_offset_,
                            base::Bind(&URLRequestAsarJob::DidSeek,
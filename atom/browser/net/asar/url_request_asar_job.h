@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "net/http/http_byte_range.h"
 #include "net/url_request/url_request_job.h"
 
@@ -109,6 +110,13 @@ class URLRequestAsarJob : public net::URLRequestJob {
   base::FilePath file_path_;
   Archive::FileInfo file_info_;
 
+  // View of the packed file in the archive's mapping, kept valid by
+  // |archive_|. Used instead of |stream_| when |use_mapping_| is set, it is
+  // only read on the file task runner.
+  base::StringPiece mapped_contents_;
+  bool use_mapping_;
+  int64_t mapped_position_;
+
   std::unique_ptr<net::FileStream> stream_;
   FileMetaInfo meta_info_;
 
@@ -7,14 +7,13 @@
 #include <memory>
 #include <utility>
 
-#include "atom/browser/extensions/tab_helper.h"
+#include "atom/browser/extensions/tab_registry.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/stl_util.h"
 #include "base/strings/string_util.h"
 #include "chrome/browser/extensions/api/tabs/tabs_constants.h"
 #include "content/common/devtools/devtools_network_transaction.h"
 #include "content/public/browser/browser_thread.h"
-#include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/websocket_handshake_request_info.h"
 #include "extensions/features/features.h"
 #include "net/url_request/url_request.h"
@@ -50,6 +49,9 @@ const char* ResourceTypeToString(content::ResourceType type) {
 
 namespace {
 
+// Maximum number of events buffered for a batched listener.
+const size_t kMaxBatchedEvents = 1024;
+
 struct ResponseHeadersContainer {
   scoped_refptr<net::HttpResponseHeaders>* headers;
   std::string status_line;
@@ -61,53 +63,22 @@ struct ResponseHeadersContainer {
         : headers(headers), status_line(status_line), new_url(new_url) {}
 };
 
-int GetTabId(int frame_tree_node_id,
-             int render_frame_id,
-             int render_process_id) {
-  auto web_contents =
-      content::WebContents::FromFrameTreeNodeId(frame_tree_node_id);
-
-  if (!web_contents) {
-    content::RenderFrameHost* rfh =
-        content::RenderFrameHost::FromID(render_process_id, render_frame_id);
-    if (rfh)
-      web_contents = content::WebContents::FromRenderFrameHost(rfh);
-  }
-
-  return extensions::TabHelper::IdForTab(web_contents);
-}
-
 void RunSimpleListener(const AtomNetworkDelegate::SimpleListener& listener,
-                       std::unique_ptr<base::DictionaryValue> details,
-                       int frame_tree_node_id,
-                       int render_frame_id,
-                       int render_process_id) {
-  details->SetInteger(extensions::tabs_constants::kTabIdKey,
-      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
+                       std::unique_ptr<base::DictionaryValue> details) {
   return listener.Run(*(details.get()));
 }
 
 void RunResponseListener(
     const AtomNetworkDelegate::ResponseListener& listener,
     std::unique_ptr<base::DictionaryValue> details,
-    int frame_tree_node_id, int render_frame_id, int render_process_id,
     const AtomNetworkDelegate::ResponseCallback& callback) {
-  details->SetInteger(extensions::tabs_constants::kTabIdKey,
-      GetTabId(frame_tree_node_id, render_frame_id, render_process_id));
   return listener.Run(*(details.get()), callback);
 }
 
 // Test whether the URL of |request| matches |patterns|.
 bool MatchesFilterCondition(net::URLRequest* request,
-                            const URLPatterns& patterns) {
-  if (patterns.empty())
-    return true;
-
-  for (const auto& pattern : patterns) {
-    if (pattern.MatchesURL(request->url()))
-      return true;
-  }
-  return false;
+                            const URLPatternIndex& patterns) {
+  return patterns.Matches(request->url());
 }
 
 void GetRenderFrameIdAndProcessId(net::URLRequest* request,
@@ -136,20 +107,63 @@ void GetFrameTreeNodeId(net::URLRequest* request, int* frame_tree_node_id) {
     *frame_tree_node_id = request_info->GetFrameTreeNodeId();
 }
 
-// Overloaded by multiple types to fill the |details| object.
-void ToDictionary(base::DictionaryValue* details, net::URLRequest* request) {
-  FillRequestDetails(details, request);
-  details->SetInteger("id", request->identifier());
-  details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
-  details->SetString("firstPartyUrl", request->site_for_cookies().spec());
-  auto info = content::ResourceRequestInfo::ForRequest(request);
-  details->SetString("resourceType",
-                     info ? ResourceTypeToString(info->GetResourceType())
-                          : "other");
+// Reads the tab of |request| from the snapshot of the tab registry, so it
+// doesn't need the UI thread.
+int GetTabId(net::URLRequest* request) {
+  int frame_tree_node_id = -1;
+  GetFrameTreeNodeId(request, &frame_tree_node_id);
+
+  int render_frame_id = -1;
+  int render_process_id = -1;
+  GetRenderFrameIdAndProcessId(request, &render_frame_id, &render_process_id);
+
+  return extensions::TabRegistry::GetInstance()->GetTabIdForFrame(
+      frame_tree_node_id, render_process_id, render_frame_id);
+}
+
+// Overloaded by multiple types to fill the |details| object with the
+// requested |fields|.
+void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
+                  net::URLRequest* request) {
+  if (fields & AtomNetworkDelegate::kFieldMethod)
+    details->SetString("method", request->method());
+  if (fields & AtomNetworkDelegate::kFieldUrl) {
+    std::string url;
+    if (!request->url_chain().empty()) url = request->url().spec();
+    details->SetKey("url", base::Value(url));
+  }
+  if (fields & AtomNetworkDelegate::kFieldReferrer)
+    details->SetString("referrer", request->referrer());
+  if (fields & AtomNetworkDelegate::kFieldTabId)
+    details->SetInteger(extensions::tabs_constants::kTabIdKey,
+                        GetTabId(request));
+  if (fields & AtomNetworkDelegate::kFieldUploadData) {
+    std::unique_ptr<base::ListValue> list(new base::ListValue);
+    GetUploadData(list.get(), request);
+    if (!list->empty())
+      details->Set("uploadData", std::move(list));
+  }
+  if (fields & AtomNetworkDelegate::kFieldId)
+    details->SetInteger("id", request->identifier());
+  if (fields & AtomNetworkDelegate::kFieldTimestamp)
+    details->SetDouble("timestamp", base::Time::Now().ToDoubleT() * 1000);
+  if (fields & AtomNetworkDelegate::kFieldFirstPartyUrl)
+    details->SetString("firstPartyUrl", request->site_for_cookies().spec());
+  if (fields & AtomNetworkDelegate::kFieldResourceType) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    details->SetString("resourceType",
+                       info ? ResourceTypeToString(info->GetResourceType())
+                            : "other");
+  }
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
                   const net::HttpRequestHeaders& headers) {
+  if (!(fields & AtomNetworkDelegate::kFieldRequestHeaders))
+    return;
+
   std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
   net::HttpRequestHeaders::Iterator it(headers);
   while (it.GetNext())
@@ -158,59 +172,78 @@ void ToDictionary(base::DictionaryValue* details,
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
                   const net::HttpResponseHeaders* headers) {
   if (!headers)
     return;
 
-  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
-  size_t iter = 0;
-  std::string key;
-  std::string value;
-  while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
-    if (dict->HasKey(key)) {
-      base::ListValue* values = nullptr;
-      if (dict->GetList(key, &values))
+  if (fields & AtomNetworkDelegate::kFieldResponseHeaders) {
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    size_t iter = 0;
+    std::string key;
+    std::string value;
+    while (headers->EnumerateHeaderLines(&iter, &key, &value)) {
+      if (dict->HasKey(key)) {
+        base::ListValue* values = nullptr;
+        if (dict->GetList(key, &values))
+          values->AppendString(value);
+      } else {
+        std::unique_ptr<base::ListValue> values(new base::ListValue);
         values->AppendString(value);
-    } else {
-      std::unique_ptr<base::ListValue> values(new base::ListValue);
-      values->AppendString(value);
-      dict->Set(key, std::move(values));
+        dict->Set(key, std::move(values));
+      }
     }
+    details->Set("responseHeaders", std::move(dict));
   }
-  details->Set("responseHeaders", std::move(dict));
-  details->SetString("statusLine", headers->GetStatusLine());
-  details->SetInteger("statusCode", headers->response_code());
+  if (fields & AtomNetworkDelegate::kFieldStatusLine)
+    details->SetString("statusLine", headers->GetStatusLine());
+  if (fields & AtomNetworkDelegate::kFieldStatusCode)
+    details->SetInteger("statusCode", headers->response_code());
 }
 
-void ToDictionary(base::DictionaryValue* details, const GURL& location) {
-  details->SetString("redirectURL", location.spec());
+void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
+                  const GURL& location) {
+  if (fields & AtomNetworkDelegate::kFieldRedirectURL)
+    details->SetString("redirectURL", location.spec());
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
                   const net::HostPortPair& host_port) {
-  if (host_port.host().empty())
+  if ((fields & AtomNetworkDelegate::kFieldIp) && host_port.host().empty())
     details->SetString("ip", host_port.host());
 }
 
-void ToDictionary(base::DictionaryValue* details, bool from_cache) {
-  details->SetBoolean("fromCache", from_cache);
+void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
+                  bool from_cache) {
+  if (fields & AtomNetworkDelegate::kFieldFromCache)
+    details->SetBoolean("fromCache", from_cache);
 }
 
 void ToDictionary(base::DictionaryValue* details,
+                  uint32_t fields,
                   const net::URLRequestStatus& status) {
-  details->SetString("error", net::ErrorToString(status.error()));
+  if (fields & AtomNetworkDelegate::kFieldError)
+    details->SetString("error", net::ErrorToString(status.error()));
 }
 
 // Helper function to fill |details| with arbitrary |args|.
 template<typename Arg>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg) {
-  ToDictionary(details, arg);
+void FillDetailsObject(base::DictionaryValue* details,
+                       uint32_t fields,
+                       Arg arg) {
+  ToDictionary(details, fields, arg);
 }
 
 template<typename Arg, typename... Args>
-void FillDetailsObject(base::DictionaryValue* details, Arg arg, Args... args) {
-  ToDictionary(details, arg);
-  FillDetailsObject(details, args...);
+void FillDetailsObject(base::DictionaryValue* details,
+                       uint32_t fields,
+                       Arg arg,
+                       Args... args) {
+  ToDictionary(details, fields, arg);
+  FillDetailsObject(details, fields, args...);
 }
 
 // Fill the native types with the result from the response object.
@@ -273,24 +306,104 @@ AtomNetworkDelegate::AtomNetworkDelegate() : weak_factory_(this) {
 AtomNetworkDelegate::~AtomNetworkDelegate() {
 }
 
+// static
+bool AtomNetworkDelegate::GetDetailsField(const std::string& name,
+                                          uint32_t* field) {
+  static const struct {
+    const char* name;
+    DetailsField field;
+  } kFields[] = {
+    { "id", kFieldId },
+    { "url", kFieldUrl },
+    { "method", kFieldMethod },
+    { "referrer", kFieldReferrer },
+    { "uploadData", kFieldUploadData },
+    { "timestamp", kFieldTimestamp },
+    { "firstPartyUrl", kFieldFirstPartyUrl },
+    { "resourceType", kFieldResourceType },
+    { extensions::tabs_constants::kTabIdKey, kFieldTabId },
+    { "requestHeaders", kFieldRequestHeaders },
+    { "responseHeaders", kFieldResponseHeaders },
+    { "statusLine", kFieldStatusLine },
+    { "statusCode", kFieldStatusCode },
+    { "redirectURL", kFieldRedirectURL },
+    { "ip", kFieldIp },
+    { "fromCache", kFieldFromCache },
+    { "error", kFieldError },
+  };
+  for (const auto& entry : kFields) {
+    if (name == entry.name) {
+      *field = entry.field;
+      return true;
+    }
+  }
+  return false;
+}
+
+AtomNetworkDelegate::BatchedEvent::BatchedEvent() {
+}
+
+AtomNetworkDelegate::BatchedEvent::BatchedEvent(BatchedEvent&& other) = default;
+
+AtomNetworkDelegate::BatchedEvent::~BatchedEvent() {
+}
+
+AtomNetworkDelegate::BatchedEvent&
+AtomNetworkDelegate::BatchedEvent::operator=(BatchedEvent&& other) = default;
+
+AtomNetworkDelegate::EventBatch::EventBatch()
+    : head(0), count(0), dropped(0), flush_pending(false) {
+}
+
+AtomNetworkDelegate::EventBatch::~EventBatch() {
+}
+
 void AtomNetworkDelegate::SetSimpleListenerInIO(
     SimpleEvent type,
     const URLPatterns& patterns,
+    uint32_t fields,
     const SimpleListener& callback) {
+  // Deliver the events batched for the old listener before replacing it.
+  FlushBatch(type);
+  batches_.erase(type);
   if (callback.is_null())
     simple_listeners_.erase(type);
   else
-    simple_listeners_[type] = { patterns, callback };
+    simple_listeners_[type] = {
+        std::make_shared<URLPatternIndex>(patterns), fields, callback };
+}
+
+void AtomNetworkDelegate::SetBatchListenerInIO(
+    SimpleEvent type,
+    const URLPatterns& patterns,
+    uint32_t fields,
+    base::TimeDelta interval,
+    const BatchListener& callback) {
+  FlushBatch(type);
+  batches_.erase(type);
+  if (callback.is_null())
+    simple_listeners_.erase(type);
+  else
+    simple_listeners_[type] = {
+        std::make_shared<URLPatternIndex>(patterns), fields, SimpleListener(),
+        callback, interval };
 }
 
 void AtomNetworkDelegate::SetResponseListenerInIO(
     ResponseEvent type,
     const URLPatterns& patterns,
+    uint32_t fields,
     const ResponseListener& callback) {
   if (callback.is_null())
     response_listeners_.erase(type);
   else
-    response_listeners_[type] = { patterns, callback };
+    response_listeners_[type] = {
+        std::make_shared<URLPatternIndex>(patterns), fields, callback };
+}
+
+void AtomNetworkDelegate::SetRulesInIO(
+    std::unique_ptr<WebRequestRules> rules) {
+  rules_ = std::move(rules);
 }
 
 void AtomNetworkDelegate::SetDevToolsNetworkEmulationClientId(
@@ -303,6 +416,13 @@ int AtomNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  if (rules_) {
+    if (rules_->ShouldBlock(request))
+      return net::ERR_BLOCKED_BY_CLIENT;
+    if (rules_->GetRedirectURL(request, new_url))
+      return net::OK;
+  }
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeRequest))
     return brightray::NetworkDelegate::OnBeforeURLRequest(
         request, callback, new_url);
@@ -324,6 +444,8 @@ int AtomNetworkDelegate::OnBeforeStartTransaction(
     headers->SetHeader(content::DevToolsNetworkTransaction::
                            kDevToolsEmulateNetworkConditionsClientId,
                        client_id);
+  if (rules_)
+    rules_->ApplyRequestHeaders(request, headers);
   if (!base::ContainsKey(response_listeners_, kOnBeforeSendHeaders))
     return brightray::NetworkDelegate::OnBeforeStartTransaction(
         request, callback, headers);
@@ -349,6 +471,13 @@ int AtomNetworkDelegate::OnHeadersReceived(
     const net::HttpResponseHeaders* original,
     scoped_refptr<net::HttpResponseHeaders>* override,
     GURL* new_url) {
+  if (rules_) {
+    rules_->ApplyResponseHeaders(request, original, override);
+    // Listeners see the headers after the rules have been applied.
+    if (override->get())
+      original = override->get();
+  }
+
   if (!base::ContainsKey(response_listeners_, kOnHeadersReceived))
     return brightray::NetworkDelegate::OnHeadersReceived(
         request, callback, original, override, new_url);
@@ -434,29 +563,21 @@ int AtomNetworkDelegate::HandleResponseEvent(
     Out out,
     Args... args) {
   const auto& info = response_listeners_[type];
-  if (!MatchesFilterCondition(request, info.url_patterns))
+  if (!MatchesFilterCondition(request, *info.url_patterns))
     return net::OK;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
 
   // The |request| could be destroyed before the |callback| is called.
   callbacks_[request->identifier()] = callback;
 
-  int frame_tree_node_id = -1;
-  GetFrameTreeNodeId(request, &frame_tree_node_id);
-
-  int render_frame_id = -1;
-  int render_process_id = -1;
-  GetRenderFrameIdAndProcessId(request, &render_frame_id, &render_process_id);
-
   ResponseCallback response =
       base::Bind(&AtomNetworkDelegate::OnListenerResultInUI<Out>,
                  weak_factory_.GetWeakPtr(), request->identifier(), out);
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(RunResponseListener, info.listener, base::Passed(&details),
-                 frame_tree_node_id, render_frame_id, render_process_id,
                  response));
   return net::ERR_IO_PENDING;
 }
@@ -465,23 +586,95 @@ template<typename...Args>
 void AtomNetworkDelegate::HandleSimpleEvent(
     SimpleEvent type, net::URLRequest* request, Args... args) {
   const auto& info = simple_listeners_[type];
-  if (!MatchesFilterCondition(request, info.url_patterns))
+  if (!MatchesFilterCondition(request, *info.url_patterns))
     return;
 
   std::unique_ptr<base::DictionaryValue> details(new base::DictionaryValue);
-  FillDetailsObject(details.get(), request, args...);
+  FillDetailsObject(details.get(), info.fields, request, args...);
 
-  int frame_tree_node_id = -1;
-  GetFrameTreeNodeId(request, &frame_tree_node_id);
+  if (!info.batch_listener.is_null()) {
+    BatchedEvent event;
+    event.details = std::move(details);
+    AddToBatch(type, std::move(event));
+    return;
+  }
 
-  int render_frame_id = -1;
-  int render_process_id = -1;
-  GetRenderFrameIdAndProcessId(request, &render_frame_id, &render_process_id);
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(RunSimpleListener, info.listener, base::Passed(&details)));
+}
+
+void AtomNetworkDelegate::AddToBatch(SimpleEvent type, BatchedEvent event) {
+  EventBatch& batch = batches_[type];
+  if (batch.events.empty())
+    batch.events.resize(kMaxBatchedEvents);
+
+  size_t index;
+  if (batch.count == kMaxBatchedEvents) {
+    // Overwrite the oldest event.
+    index = batch.head;
+    batch.head = (batch.head + 1) % kMaxBatchedEvents;
+    ++batch.dropped;
+  } else {
+    index = (batch.head + batch.count) % kMaxBatchedEvents;
+    ++batch.count;
+  }
+  batch.events[index] = std::move(event);
+
+  if (!batch.flush_pending) {
+    batch.flush_pending = true;
+    BrowserThread::PostDelayedTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&AtomNetworkDelegate::FlushBatch,
+                   weak_factory_.GetWeakPtr(), type),
+        simple_listeners_[type].batch_interval);
+  }
+}
+
+void AtomNetworkDelegate::FlushBatch(SimpleEvent type) {
+  auto it = batches_.find(type);
+  if (it == batches_.end())
+    return;
+  // The listener may have been replaced since the flush was scheduled.
+  auto listener = simple_listeners_.find(type);
+  if (listener == simple_listeners_.end() ||
+      listener->second.batch_listener.is_null()) {
+    batches_.erase(it);
+    return;
+  }
+
+  EventBatch& batch = it->second;
+  batch.flush_pending = false;
+  if (batch.count == 0 && batch.dropped == 0)
+    return;
+
+  std::unique_ptr<std::vector<BatchedEvent>> events(
+      new std::vector<BatchedEvent>);
+  events->reserve(batch.count);
+  for (size_t i = 0; i < batch.count; ++i)
+    events->push_back(std::move(
+        batch.events[(batch.head + i) % kMaxBatchedEvents]));
+  int dropped = batch.dropped;
+  batch.head = 0;
+  batch.count = 0;
+  batch.dropped = 0;
 
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
-      base::Bind(RunSimpleListener, info.listener, base::Passed(&details),
-          frame_tree_node_id, render_frame_id, render_process_id));
+      base::Bind(&AtomNetworkDelegate::RunBatchListener,
+                 listener->second.batch_listener, base::Passed(&events),
+                 dropped));
+}
+
+// static
+void AtomNetworkDelegate::RunBatchListener(
+    const BatchListener& listener,
+    std::unique_ptr<std::vector<BatchedEvent>> events,
+    int dropped) {
+  base::ListValue list;
+  for (auto& event : *events)
+    list.Append(std::move(event.details));
+  listener.Run(list, dropped);
 }
 
 template<typename T>
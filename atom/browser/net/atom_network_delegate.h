@@ -9,10 +9,14 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "atom/browser/net/url_pattern_index.h"
+#include "atom/browser/net/web_request_rules.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "brightray/browser/network_delegate.h"
 #include "content/public/browser/resource_request_info.h"
@@ -33,6 +37,9 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   using SimpleListener = base::Callback<void(const base::DictionaryValue&)>;
   using ResponseListener = base::Callback<void(const base::DictionaryValue&,
                                                const ResponseCallback&)>;
+  // Receives the details of a batch of events and the number of events that
+  // were dropped since the previous batch.
+  using BatchListener = base::Callback<void(const base::ListValue&, int)>;
 
   enum SimpleEvent {
     kOnSendHeaders,
@@ -48,26 +55,69 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
     kOnHeadersReceived,
   };
 
+  // Fields of the details object, listeners can ask for a subset of them so
+  // only those are computed and serialized.
+  enum DetailsField : uint32_t {
+    kFieldId = 1 << 0,
+    kFieldUrl = 1 << 1,
+    kFieldMethod = 1 << 2,
+    kFieldReferrer = 1 << 3,
+    kFieldUploadData = 1 << 4,
+    kFieldTimestamp = 1 << 5,
+    kFieldFirstPartyUrl = 1 << 6,
+    kFieldResourceType = 1 << 7,
+    kFieldTabId = 1 << 8,
+    kFieldRequestHeaders = 1 << 9,
+    kFieldResponseHeaders = 1 << 10,
+    kFieldStatusLine = 1 << 11,
+    kFieldStatusCode = 1 << 12,
+    kFieldRedirectURL = 1 << 13,
+    kFieldIp = 1 << 14,
+    kFieldFromCache = 1 << 15,
+    kFieldError = 1 << 16,
+    kAllFields = 0xffffffff,
+  };
+
   struct SimpleListenerInfo {
-    URLPatterns url_patterns;
+    std::shared_ptr<URLPatternIndex> url_patterns;
+    uint32_t fields;
     SimpleListener listener;
+    // Set instead of |listener| when events are delivered in batches.
+    BatchListener batch_listener;
+    base::TimeDelta batch_interval;
   };
 
   struct ResponseListenerInfo {
-    URLPatterns url_patterns;
+    std::shared_ptr<URLPatternIndex> url_patterns;
+    uint32_t fields;
     ResponseListener listener;
   };
 
+  // Converts the |name| of a details property to its DetailsField.
+  static bool GetDetailsField(const std::string& name, uint32_t* field);
+
   AtomNetworkDelegate();
   ~AtomNetworkDelegate() override;
 
   void SetSimpleListenerInIO(SimpleEvent type,
                              const URLPatterns& patterns,
+                             uint32_t fields,
                              const SimpleListener& callback);
+  // Like SetSimpleListenerInIO, but the events are buffered and delivered
+  // together at most once every |interval|.
+  void SetBatchListenerInIO(SimpleEvent type,
+                            const URLPatterns& patterns,
+                            uint32_t fields,
+                            base::TimeDelta interval,
+                            const BatchListener& callback);
   void SetResponseListenerInIO(ResponseEvent type,
                                const URLPatterns& patterns,
+                               uint32_t fields,
                                const ResponseListener& callback);
 
+  // Replaces the declarative rules, nullptr removes them.
+  void SetRulesInIO(std::unique_ptr<WebRequestRules> rules);
+
   void SetDevToolsNetworkEmulationClientId(const std::string& client_id);
 
  protected:
@@ -95,6 +145,33 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
   void OnURLRequestDestroyed(net::URLRequest* request) override;
 
  private:
+  struct BatchedEvent {
+    BatchedEvent();
+    BatchedEvent(BatchedEvent&& other);
+    ~BatchedEvent();
+    BatchedEvent& operator=(BatchedEvent&& other);
+
+    std::unique_ptr<base::DictionaryValue> details;
+  };
+
+  // Fixed size ring buffer of the events waiting to be flushed, the oldest
+  // events are dropped when it is full.
+  struct EventBatch {
+    EventBatch();
+    ~EventBatch();
+
+    std::vector<BatchedEvent> events;
+    size_t head;
+    size_t count;
+    int dropped;
+    bool flush_pending;
+  };
+
+  static void RunBatchListener(
+      const BatchListener& listener,
+      std::unique_ptr<std::vector<BatchedEvent>> events,
+      int dropped);
+
   void OnErrorOccurred(net::URLRequest* request, bool started, int net_error);
 
   template<typename...Args>
@@ -108,6 +185,9 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
                           Out out,
                           Args... args);
 
+  void AddToBatch(SimpleEvent type, BatchedEvent event);
+  void FlushBatch(SimpleEvent type);
+
   // Deal with the results of Listener.
   template<typename T>
   void OnListenerResultInIO(
@@ -119,7 +199,9 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
 
   std::map<SimpleEvent, SimpleListenerInfo> simple_listeners_;
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
+  std::map<SimpleEvent, EventBatch> batches_;
   std::map<uint64_t, net::CompletionCallback> callbacks_;
+  std::unique_ptr<WebRequestRules> rules_;
 
   base::Lock lock_;
 
@@ -9,6 +9,8 @@
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 
+#include "atom/common/node_includes.h"
+
 namespace atom {
 
 namespace internal {
@@ -17,6 +19,7 @@ namespace {
 
 // The callback which is passed to |handler|.
 void HandlerCallback(const BeforeStartCallback& before_start,
+                     const TakeResponseDataCallback& take_data,
                      const ResponseCallback& callback,
                      mate::Arguments* args) {
   // If there is no argument passed then we failed.
@@ -24,20 +27,31 @@ void HandlerCallback(const BeforeStartCallback& before_start,
   if (!args->GetNext(&value)) {
     content::BrowserThread::PostTask(
         content::BrowserThread::IO, FROM_HERE,
-        base::Bind(callback, false, nullptr));
+        base::Bind(callback, false, nullptr, nullptr));
     return;
   }
 
   // Give the job a chance to parse V8 value.
   before_start.Run(args->isolate(), value);
 
+  // What the job takes itself is posted to it with the options, the job
+  // can't be used on this thread.
+  bool convert_buffers = take_data.is_null();
+  std::unique_ptr<ResponseData> data;
+  if (!convert_buffers)
+    data = take_data.Run(args->isolate(), value);
+
   // Pass whatever user passed to the actaul request job.
   V8ValueConverter converter;
+  converter.SetBufferAllowed(convert_buffers);
   v8::Local<v8::Context> context = args->isolate()->GetCurrentContext();
   std::unique_ptr<base::Value> options(converter.FromV8Value(value, context));
+  // A Buffer the job takes itself comes with no other options.
+  if (!options && !convert_buffers && node::Buffer::HasInstance(value))
+    options.reset(new base::DictionaryValue);
   content::BrowserThread::PostTask(
       content::BrowserThread::IO, FROM_HERE,
-      base::Bind(callback, true, base::Passed(&options)));
+      base::Bind(callback, true, base::Passed(&options), base::Passed(&data)));
 }
 
 }  // namespace
@@ -46,6 +60,7 @@ void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    std::unique_ptr<base::DictionaryValue> request_details,
                    const BeforeStartCallback& before_start,
+                   const TakeResponseDataCallback& take_data,
                    const ResponseCallback& callback) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
   v8::Locker locker(isolate);
@@ -55,7 +70,8 @@ void AskForOptions(v8::Isolate* isolate,
   handler.Run(
       *(request_details.get()),
       mate::ConvertToV8(isolate,
-                        base::Bind(&HandlerCallback, before_start, callback)));
+                        base::Bind(&HandlerCallback, before_start,
+                                   take_data, callback)));
 }
 
 bool IsErrorOptions(base::Value* value, int* error) {
@@ -27,16 +27,30 @@ using JavaScriptHandler =
 
 namespace internal {
 
+// What a job takes from the response of the handler itself on the UI thread,
+// like a Buffer. It is handed to the job on the IO thread with the options.
+class ResponseData {
+ public:
+  virtual ~ResponseData() {}
+};
+
 using BeforeStartCallback =
     base::Callback<void(v8::Isolate*, v8::Local<v8::Value>)>;
+using TakeResponseDataCallback =
+    base::Callback<std::unique_ptr<ResponseData>(v8::Isolate*,
+                                                 v8::Local<v8::Value>)>;
 using ResponseCallback =
-    base::Callback<void(bool, std::unique_ptr<base::Value> options)>;
+    base::Callback<void(bool,
+                        std::unique_ptr<base::Value> options,
+                        std::unique_ptr<ResponseData> data)>;
 
-// Ask handler for options in UI thread.
+// Ask handler for options in UI thread. When |take_data| is set it runs on
+// the response first, and Buffers are left out of the options.
 void AskForOptions(v8::Isolate* isolate,
                    const JavaScriptHandler& handler,
                    std::unique_ptr<base::DictionaryValue> request_details,
                    const BeforeStartCallback& before_start,
+                   const TakeResponseDataCallback& take_data,
                    const ResponseCallback& callback);
 
 // Test whether the |options| means an error.
@@ -64,6 +78,15 @@ class JsAsker : public RequestJob {
   virtual void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) {}
   virtual void StartAsync(std::unique_ptr<base::Value> options) = 0;
 
+  // Subclasses taking parts of the response themselves, like Buffers, return
+  // the function doing it on the UI thread. It must not use the job, which
+  // lives on the IO thread. Buffers are then not copied into the options.
+  virtual internal::TakeResponseDataCallback GetTakeResponseData() const {
+    return internal::TakeResponseDataCallback();
+  }
+  // Called with what was taken before StartAsync.
+  virtual void SetResponseData(std::unique_ptr<internal::ResponseData> data) {}
+
   net::URLRequestContextGetter* request_context_getter() const {
     return request_context_getter_;
   }
@@ -82,6 +105,7 @@ class JsAsker : public RequestJob {
                    base::Passed(&request_details),
                    base::Bind(&JsAsker::BeforeStartInUI,
                               weak_factory_.GetWeakPtr()),
+                   GetTakeResponseData(),
                    base::Bind(&JsAsker::OnResponse,
                               weak_factory_.GetWeakPtr())));
   }
@@ -91,9 +115,12 @@ class JsAsker : public RequestJob {
 
   // Called when the JS handler has sent the response, we need to decide whether
   // to start, or fail the job.
-  void OnResponse(bool success, std::unique_ptr<base::Value> value) {
+  void OnResponse(bool success,
+                  std::unique_ptr<base::Value> value,
+                  std::unique_ptr<internal::ResponseData> data) {
     int error = net::ERR_NOT_IMPLEMENTED;
     if (success && value && !internal::IsErrorOptions(value.get(), &error)) {
+      SetResponseData(std::move(data));
       StartAsync(std::move(value));
     } else {
       RequestJob::NotifyStartError(
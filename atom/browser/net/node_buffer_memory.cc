@@ -0,0 +1,121 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/node_buffer_memory.h"
+
+#include "base/memory/ref_counted.h"
+#include "content/public/browser/browser_thread.h"
+#include "gin/array_buffer.h"
+
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// Links an externalized ArrayBuffer to its BackingStore.
+const char kBackingStoreKey[] = "NodeBufferMemory::BackingStore";
+
+}  // namespace
+
+// Owns the externalized memory of an ArrayBuffer, the ArrayBuffer keeps a
+// reference until it is collected.
+class NodeBufferMemory::BackingStore
+    : public base::RefCountedThreadSafe<BackingStore> {
+ public:
+  // Returns nullptr if the memory of |array_buffer| is owned by somebody else.
+  static scoped_refptr<BackingStore> From(
+      v8::Isolate* isolate, v8::Local<v8::ArrayBuffer> array_buffer) {
+    v8::Local<v8::Context> context = isolate->GetCurrentContext();
+    v8::Local<v8::Private> key = v8::Private::ForApi(
+        isolate, v8::String::NewFromUtf8(isolate, kBackingStoreKey));
+    v8::Local<v8::Value> store;
+    if (array_buffer->GetPrivate(context, key).ToLocal(&store) &&
+        store->IsExternal())
+      return static_cast<BackingStore*>(store.As<v8::External>()->Value());
+
+    if (array_buffer->IsExternal() || !array_buffer->IsNeuterable())
+      return nullptr;
+
+    scoped_refptr<BackingStore> result(new BackingStore(isolate, array_buffer));
+    if (!array_buffer->SetPrivate(context, key,
+            v8::External::New(isolate, result.get())).FromMaybe(false))
+      LOG(WARNING) << "Failed to link an ArrayBuffer to its memory";
+    return result;
+  }
+
+  const unsigned char* data() const {
+    return static_cast<const unsigned char*>(contents_.Data());
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<BackingStore>;
+
+  BackingStore(v8::Isolate* isolate, v8::Local<v8::ArrayBuffer> array_buffer)
+      : contents_(array_buffer->Externalize()),
+        array_buffer_(isolate, array_buffer) {
+    // Released when the ArrayBuffer is collected.
+    AddRef();
+    array_buffer_.SetWeak(this, &BackingStore::OnCollected,
+                          v8::WeakCallbackType::kParameter);
+  }
+
+  ~BackingStore() {
+    // All isolates allocate ArrayBuffers with the same allocator.
+    gin::ArrayBufferAllocator::SharedInstance()->Free(contents_.Data(),
+                                                      contents_.ByteLength());
+  }
+
+  static void OnCollected(const v8::WeakCallbackInfo<BackingStore>& data) {
+    BackingStore* self = data.GetParameter();
+    self->array_buffer_.Reset();
+    self->Release();
+  }
+
+  v8::ArrayBuffer::Contents contents_;
+  v8::Global<v8::ArrayBuffer> array_buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(BackingStore);
+};
+
+// static
+scoped_refptr<base::RefCountedMemory> NodeBufferMemory::FromV8(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!node::Buffer::HasInstance(value))
+    return nullptr;
+
+  v8::Local<v8::ArrayBufferView> view = value.As<v8::ArrayBufferView>();
+  size_t size = view->ByteLength();
+  scoped_refptr<BackingStore> store =
+      BackingStore::From(isolate, view->Buffer());
+  if (!store) {
+    // The memory could go away while it is read.
+    return new base::RefCountedBytes(
+        reinterpret_cast<const unsigned char*>(node::Buffer::Data(value)),
+        size);
+  }
+  return new NodeBufferMemory(store, store->data() + view->ByteOffset(), size);
+}
+
+NodeBufferMemory::NodeBufferMemory(scoped_refptr<BackingStore> store,
+                                   const unsigned char* data,
+                                   size_t size)
+    : store_(store), data_(data), size_(size) {
+}
+
+NodeBufferMemory::~NodeBufferMemory() {
+}
+
+const unsigned char* NodeBufferMemory::front() const {
+  return data_;
+}
+
+size_t NodeBufferMemory::size() const {
+  return size_;
+}
+
+}  // namespace atom
@@ -0,0 +1,48 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_NODE_BUFFER_MEMORY_H_
+#define ATOM_BROWSER_NET_NODE_BUFFER_MEMORY_H_
+
+#include "base/macros.h"
+#include "base/memory/ref_counted_memory.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+
+// The contents of a Node Buffer, usable on any thread without copying them.
+//
+// The memory of the Buffer's ArrayBuffer is externalized, so it can't be
+// detached anymore (workers refuse to transfer external ArrayBuffers), and
+// is freed once the ArrayBuffer has been collected and is no longer used
+// here. JavaScript must not change the Buffer in the meantime.
+class NodeBufferMemory : public base::RefCountedMemory {
+ public:
+  // Must be called on the UI thread, returns nullptr if |value| is not a
+  // Buffer. Buffers whose memory is owned by somebody else are copied.
+  static scoped_refptr<base::RefCountedMemory> FromV8(
+      v8::Isolate* isolate, v8::Local<v8::Value> value);
+
+  // base::RefCountedMemory:
+  const unsigned char* front() const override;
+  size_t size() const override;
+
+ private:
+  class BackingStore;
+
+  NodeBufferMemory(scoped_refptr<BackingStore> store,
+                   const unsigned char* data,
+                   size_t size);
+  ~NodeBufferMemory() override;
+
+  scoped_refptr<BackingStore> store_;
+  const unsigned char* data_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(NodeBufferMemory);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_NODE_BUFFER_MEMORY_H_
@@ -0,0 +1,98 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_pattern_index.h"
+
+#include "base/strings/string_util.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+URLPatternIndex::URLPatternIndex(const std::set<URLPattern>& patterns) {
+  patterns_.reserve(patterns.size());
+  for (const auto& pattern : patterns) {
+    Entry entry = { pattern, base::ToLowerASCII(pattern.host()),
+                    pattern.match_all_urls() ? std::string() : pattern.path() };
+    // URLPattern also matches "/foo" against "/foo/*", so the prefix stops
+    // before the last '/' ahead of the first wildcard. '?' is a literal in
+    // URLPattern paths, but it starts the query which is not part of
+    // GURL::path(), so it is cut as well.
+    size_t wildcard = entry.path_prefix.find_first_of("*?");
+    if (wildcard != std::string::npos) {
+      size_t slash = entry.path_prefix.rfind('/', wildcard);
+      entry.path_prefix.resize(slash == std::string::npos ? 0 : slash);
+    }
+    patterns_.push_back(entry);
+  }
+
+  for (size_t i = 0; i < patterns_.size(); ++i) {
+    const Entry& entry = patterns_[i];
+    if (entry.pattern.match_all_urls() || entry.host.empty())
+      any_host_.push_back(i);
+    else if (entry.pattern.match_subdomains())
+      subdomain_hosts_[entry.host].push_back(i);
+    else
+      exact_hosts_[entry.host].push_back(i);
+  }
+}
+
+URLPatternIndex::~URLPatternIndex() {
+}
+
+bool URLPatternIndex::Matches(const GURL& url) const {
+  if (patterns_.empty())
+    return true;
+
+  // URLPattern matches filesystem: URLs against their inner URL, and
+  // non-standard URLs have no host to index by.
+  if (url.SchemeIsFileSystem() || !url.IsStandard()) {
+    for (const auto& entry : patterns_) {
+      if (entry.pattern.MatchesURL(url))
+        return true;
+    }
+    return false;
+  }
+
+  if (MatchesBucket(any_host_, url))
+    return true;
+
+  base::StringPiece host = url.host_piece();
+  if (MatchesHostMap(exact_hosts_, host, url))
+    return true;
+
+  // Try the host and each of its parent domains.
+  while (!host.empty()) {
+    if (MatchesHostMap(subdomain_hosts_, host, url))
+      return true;
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+  return false;
+}
+
+bool URLPatternIndex::MatchesBucket(const Bucket& bucket,
+                                    const GURL& url) const {
+  for (size_t i : bucket) {
+    const Entry& entry = patterns_[i];
+    if (!entry.path_prefix.empty() &&
+        !url.path_piece().starts_with(entry.path_prefix))
+      continue;
+    if (entry.pattern.MatchesURL(url))
+      return true;
+  }
+  return false;
+}
+
+bool URLPatternIndex::MatchesHostMap(const HostMap& map,
+                                     const base::StringPiece& host,
+                                     const GURL& url) const {
+  if (map.empty())
+    return false;
+  auto it = map.find(host);
+  return it != map.end() && MatchesBucket(it->second, url);
+}
+
+}  // namespace atom
@@ -0,0 +1,70 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_PATTERN_INDEX_H_
+#define ATOM_BROWSER_NET_URL_PATTERN_INDEX_H_
+
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "extensions/common/url_pattern.h"
+
+class GURL;
+
+namespace atom {
+
+// Compiled form of a set of URL patterns, built once when a webRequest
+// listener is installed.
+//
+// Patterns are bucketed by host: patterns matching any host, patterns for an
+// exact host, and patterns matching a host and its subdomains, which are
+// looked up by walking the suffixes of the request's host. Candidates are
+// then filtered by the literal prefix of their path before running the full
+// URLPattern::MatchesURL check, so a request only pays for the patterns that
+// can actually match it.
+class URLPatternIndex {
+ public:
+  explicit URLPatternIndex(const std::set<URLPattern>& patterns);
+  ~URLPatternIndex();
+
+  // Returns true if |url| matches any of the patterns, or if there are none.
+  bool Matches(const GURL& url) const;
+
+  bool empty() const { return patterns_.empty(); }
+
+ private:
+  struct Entry {
+    URLPattern pattern;
+    std::string host;
+    // The part of the path before the last '/' preceding the first wildcard,
+    // compared as is with the canonical path of the URL like URLPattern does.
+    std::string path_prefix;
+  };
+
+  using Bucket = std::vector<size_t>;
+  using HostMap =
+      std::unordered_map<base::StringPiece, Bucket, base::StringPieceHash>;
+
+  bool MatchesBucket(const Bucket& bucket, const GURL& url) const;
+  bool MatchesHostMap(const HostMap& map,
+                      const base::StringPiece& host,
+                      const GURL& url) const;
+
+  // |patterns_| is not modified after construction, the host maps point into
+  // the host strings of its entries.
+  std::vector<Entry> patterns_;
+  Bucket any_host_;
+  HostMap exact_hosts_;
+  HostMap subdomain_hosts_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLPatternIndex);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_PATTERN_INDEX_H_
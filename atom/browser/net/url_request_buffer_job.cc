@@ -7,10 +7,13 @@
 #include <memory>
 #include <string>
 
+#include "atom/browser/net/node_buffer_memory.h"
 #include "atom/common/atom_constants.h"
+#include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
 #include "net/base/mime_util.h"
+#include "native_mate/dictionary.h"
 #include "net/base/net_errors.h"
 
 namespace atom {
@@ -25,6 +28,29 @@ std::string GetExtFromURL(const GURL& url) {
   return spec.substr(index + 1, spec.size() - index - 1);
 }
 
+class BufferData : public internal::ResponseData {
+ public:
+  explicit BufferData(scoped_refptr<base::RefCountedMemory> buffer)
+      : buffer(buffer) {}
+
+  scoped_refptr<base::RefCountedMemory> buffer;
+};
+
+std::unique_ptr<internal::ResponseData> TakeBuffer(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  // The handler passes either a Buffer or an object with a Buffer in |data|.
+  scoped_refptr<base::RefCountedMemory> buffer =
+      NodeBufferMemory::FromV8(isolate, value);
+  mate::Dictionary options;
+  v8::Local<v8::Value> data;
+  if (!buffer && mate::ConvertFromV8(isolate, value, &options) &&
+      options.Get("data", &data))
+    buffer = NodeBufferMemory::FromV8(isolate, data);
+  if (!buffer)
+    return nullptr;
+  return base::MakeUnique<BufferData>(buffer);
+}
+
 }  // namespace
 
 URLRequestBufferJob::URLRequestBufferJob(
@@ -33,20 +59,23 @@ URLRequestBufferJob::URLRequestBufferJob(
       status_code_(net::HTTP_NOT_IMPLEMENTED) {
 }
 
+internal::TakeResponseDataCallback
+URLRequestBufferJob::GetTakeResponseData() const {
+  return base::Bind(&TakeBuffer);
+}
+
+void URLRequestBufferJob::SetResponseData(
+    std::unique_ptr<internal::ResponseData> data) {
+  if (data)
+    data_ = static_cast<BufferData*>(data.get())->buffer;
+}
+
 void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
-  const base::Value::BlobStorage* blob = nullptr;
   if (options->IsType(base::Value::Type::DICTIONARY)) {
-    const base::Value* binary = nullptr;
     base::DictionaryValue* dict =
         static_cast<base::DictionaryValue*>(options.get());
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
-    dict->GetBinary("data", &binary);
-    if (binary) {
-      blob = &binary->GetBlob();
-    }
-  } else if (options->is_blob()) {
-    blob = &options->GetBlob();
   }
 
   if (mime_type_.empty()) {
@@ -58,14 +87,12 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
 #endif
   }
 
-  if (!blob) {
+  if (!data_) {
     NotifyStartError(net::URLRequestStatus(
           net::URLRequestStatus::FAILED, net::ERR_NOT_IMPLEMENTED));
     return;
   }
 
-  data_ = new base::RefCountedBytes(
-      reinterpret_cast<const unsigned char*>(blob->data()), blob->size());
   status_code_ = net::HTTP_OK;
   net::URLRequestSimpleJob::Start();
 }
@@ -20,6 +20,8 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
   URLRequestBufferJob(net::URLRequest*, net::NetworkDelegate*);
 
   // JsAsker:
+  internal::TakeResponseDataCallback GetTakeResponseData() const override;
+  void SetResponseData(std::unique_ptr<internal::ResponseData> data) override;
   void StartAsync(std::unique_ptr<base::Value> options) override;
 
   // URLRequestJob:
@@ -34,7 +36,8 @@ class URLRequestBufferJob : public JsAsker<net::URLRequestSimpleJob> {
  private:
   std::string mime_type_;
   std::string charset_;
-  scoped_refptr<base::RefCountedBytes> data_;
+  // The Buffer passed by the handler, read without copying.
+  scoped_refptr<base::RefCountedMemory> data_;
   net::HttpStatusCode status_code_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestBufferJob);
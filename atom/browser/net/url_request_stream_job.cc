@@ -0,0 +1,262 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "atom/browser/net/node_buffer_memory.h"
+#include "atom/common/atom_constants.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "base/memory/ptr_util.h"
+#include "base/strings/string_number_conversions.h"
+#include "native_mate/dictionary.h"
+#include "net/base/net_errors.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+using ChunkCallback =
+    base::Callback<void(int, scoped_refptr<base::RefCountedMemory>)>;
+
+// Whether net has a reason phrase for |code|, which the response headers need.
+bool IsKnownStatusCode(int code) {
+  switch (code) {
+#define HTTP_STATUS(label, code, reason) case code: return true;
+#include "net/http/http_status_code_list.h"
+#undef HTTP_STATUS
+    default:
+      return false;
+  }
+}
+
+// The callback passed to the |data| function of the handler. It takes a
+// Buffer with the next chunk, nothing at the end of the data, or a net error
+// code.
+void OnChunkInUI(const ChunkCallback& callback, mate::Arguments* args) {
+  v8::Local<v8::Value> value;
+  int error = net::OK;
+  scoped_refptr<base::RefCountedMemory> chunk;
+  if (args->GetNext(&value) && !value->IsNullOrUndefined()) {
+    chunk = NodeBufferMemory::FromV8(args->isolate(), value);
+    if (!chunk && (!mate::ConvertFromV8(args->isolate(), value, &error) ||
+                   error >= 0))
+      error = net::ERR_FAILED;
+  }
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                          base::Bind(callback, error, chunk));
+}
+
+}  // namespace
+
+// Calls the |data| function of the handler, lives on the UI thread.
+class URLRequestStreamJob::Reader {
+ public:
+  using ReadFunction = base::Callback<void(v8::Local<v8::Value>)>;
+
+  Reader(v8::Isolate* isolate, const ReadFunction& read)
+      : isolate_(isolate), read_(read) {}
+
+  void Read(const ChunkCallback& callback) {
+    DCHECK_CURRENTLY_ON(BrowserThread::UI);
+    v8::Locker locker(isolate_);
+    v8::HandleScope handle_scope(isolate_);
+    v8::Local<v8::Context> context = isolate_->GetCurrentContext();
+    v8::Context::Scope context_scope(context);
+    read_.Run(mate::ConvertToV8(isolate_,
+                                base::Bind(&OnChunkInUI, callback)));
+  }
+
+ private:
+  v8::Isolate* isolate_;
+  ReadFunction read_;
+
+  DISALLOW_COPY_AND_ASSIGN(Reader);
+};
+
+class URLRequestStreamJob::ReaderData : public internal::ResponseData {
+ public:
+  explicit ReaderData(std::unique_ptr<Reader> reader)
+      : reader(std::move(reader)) {}
+
+  std::unique_ptr<Reader> reader;
+};
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate)
+    : JsAsker<net::URLRequestJob>(request, network_delegate),
+      status_code_(net::HTTP_OK),
+      chunk_offset_(0),
+      ended_(false),
+      pending_buffer_size_(0),
+      weak_factory_(this) {
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+  if (reader_)
+    BrowserThread::DeleteSoon(BrowserThread::UI, FROM_HERE, reader_.release());
+}
+
+// static
+std::unique_ptr<internal::ResponseData> URLRequestStreamJob::TakeReader(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  mate::Dictionary options;
+  Reader::ReadFunction read;
+  if (!mate::ConvertFromV8(isolate, value, &options) ||
+      !options.Get("data", &read))
+    return nullptr;
+  return base::MakeUnique<ReaderData>(
+      base::MakeUnique<Reader>(isolate, read));
+}
+
+internal::TakeResponseDataCallback
+URLRequestStreamJob::GetTakeResponseData() const {
+  return base::Bind(&URLRequestStreamJob::TakeReader);
+}
+
+void URLRequestStreamJob::SetResponseData(
+    std::unique_ptr<internal::ResponseData> data) {
+  if (data)
+    reader_ = std::move(static_cast<ReaderData*>(data.get())->reader);
+}
+
+void URLRequestStreamJob::StartAsync(std::unique_ptr<base::Value> options) {
+  if (!reader_ || !options->IsType(base::Value::Type::DICTIONARY)) {
+    NotifyStartError(net::URLRequestStatus(
+          net::URLRequestStatus::FAILED, net::ERR_NOT_IMPLEMENTED));
+    return;
+  }
+
+  base::DictionaryValue* dict =
+      static_cast<base::DictionaryValue*>(options.get());
+  int status_code;
+  if (dict->GetInteger("statusCode", &status_code)) {
+    if (!IsKnownStatusCode(status_code)) {
+      NotifyStartError(net::URLRequestStatus(
+            net::URLRequestStatus::FAILED, net::ERR_INVALID_ARGUMENT));
+      return;
+    }
+    status_code_ = static_cast<net::HttpStatusCode>(status_code);
+  }
+  dict->GetString("mimeType", &mime_type_);
+  base::DictionaryValue* headers = nullptr;
+  if (dict->GetDictionary("headers", &headers))
+    headers_ = headers->CreateDeepCopy();
+
+  NotifyHeadersComplete();
+}
+
+void URLRequestStreamJob::Kill() {
+  weak_factory_.InvalidateWeakPtrs();
+  JsAsker<URLRequestJob>::Kill();
+}
+
+int URLRequestStreamJob::ReadRawData(net::IOBuffer* buf, int buf_size) {
+  if (chunk_)
+    return CopyChunk(buf, buf_size);
+  if (ended_)
+    return 0;
+
+  // Only ask for the next chunk when the request is ready to take it.
+  pending_buffer_ = buf;
+  pending_buffer_size_ = buf_size;
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&Reader::Read, base::Unretained(reader_.get()),
+                 base::Bind(&URLRequestStreamJob::OnChunk,
+                            weak_factory_.GetWeakPtr())));
+  return net::ERR_IO_PENDING;
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  *mime_type = mime_type_;
+  return !mime_type_.empty();
+}
+
+void URLRequestStreamJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  std::string status("HTTP/1.1 ");
+  status.append(base::IntToString(status_code_));
+  status.append(" ");
+  status.append(net::GetHttpReasonPhrase(status_code_));
+  status.append("\0\0", 2);
+  auto* headers = new net::HttpResponseHeaders(status);
+
+  headers->AddHeader(kCORSHeader);
+
+  if (!mime_type_.empty()) {
+    std::string content_type_header(net::HttpRequestHeaders::kContentType);
+    content_type_header.append(": ");
+    content_type_header.append(mime_type_);
+    headers->AddHeader(content_type_header);
+  }
+
+  if (headers_) {
+    for (base::DictionaryValue::Iterator it(*headers_); !it.IsAtEnd();
+         it.Advance()) {
+      std::string value;
+      if (it.value().GetAsString(&value))
+        headers->AddHeader(it.key() + ": " + value);
+    }
+  }
+
+  info->headers = headers;
+}
+
+int URLRequestStreamJob::GetResponseCode() const {
+  return status_code_;
+}
+
+void URLRequestStreamJob::OnChunk(
+    int error, scoped_refptr<base::RefCountedMemory> chunk) {
+  if (!pending_buffer_)
+    return;
+
+  if (error != net::OK) {
+    pending_buffer_ = nullptr;
+    ReadRawDataComplete(error);
+    return;
+  }
+
+  if (!chunk) {
+    ended_ = true;
+    pending_buffer_ = nullptr;
+    ReadRawDataComplete(0);
+    return;
+  }
+
+  // An empty chunk would read as the end of the data.
+  if (chunk->size() == 0) {
+    scoped_refptr<net::IOBuffer> buf = pending_buffer_;
+    pending_buffer_ = nullptr;
+    int result = ReadRawData(buf.get(), pending_buffer_size_);
+    DCHECK_EQ(result, net::ERR_IO_PENDING);
+    return;
+  }
+
+  chunk_ = chunk;
+  chunk_offset_ = 0;
+  scoped_refptr<net::IOBuffer> buf = pending_buffer_;
+  pending_buffer_ = nullptr;
+  ReadRawDataComplete(CopyChunk(buf.get(), pending_buffer_size_));
+}
+
+int URLRequestStreamJob::CopyChunk(net::IOBuffer* buf, int buf_size) {
+  size_t size = std::min(chunk_->size() - chunk_offset_,
+                         static_cast<size_t>(buf_size));
+  memcpy(buf->data(), chunk_->front() + chunk_offset_, size);
+  chunk_offset_ += size;
+  // Release the Buffer as soon as it has been read.
+  if (chunk_offset_ == chunk_->size())
+    chunk_ = nullptr;
+  return static_cast<int>(size);
+}
+
+}  // namespace atom
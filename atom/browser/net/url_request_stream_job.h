@@ -0,0 +1,76 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <memory>
+#include <string>
+
+#include "atom/browser/net/js_asker.h"
+#include "base/memory/ref_counted_memory.h"
+#include "net/base/io_buffer.h"
+#include "net/http/http_status_code.h"
+
+namespace atom {
+
+// Serves the response of the handler chunk by chunk. The handler passes a
+// |data| function which is called whenever the request wants more data, so
+// the handler never produces data faster than it is consumed.
+class URLRequestStreamJob : public JsAsker<net::URLRequestJob> {
+ public:
+  URLRequestStreamJob(net::URLRequest*, net::NetworkDelegate*);
+  ~URLRequestStreamJob() override;
+
+  // JsAsker:
+  internal::TakeResponseDataCallback GetTakeResponseData() const override;
+  void SetResponseData(std::unique_ptr<internal::ResponseData> data) override;
+  void StartAsync(std::unique_ptr<base::Value> options) override;
+
+  // URLRequestJob:
+  void Kill() override;
+  int ReadRawData(net::IOBuffer* buf, int buf_size) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+  int GetResponseCode() const override;
+
+ private:
+  class Reader;
+  class ReaderData;
+
+  // Creates the Reader for the |data| function of the response, runs on the
+  // UI thread.
+  static std::unique_ptr<internal::ResponseData> TakeReader(
+      v8::Isolate* isolate, v8::Local<v8::Value> value);
+
+  // Called with the next chunk, nullptr at the end of the data.
+  void OnChunk(int error, scoped_refptr<base::RefCountedMemory> chunk);
+
+  // Moves as much of |chunk_| as fits into |buf|.
+  int CopyChunk(net::IOBuffer* buf, int buf_size);
+
+  std::string mime_type_;
+  std::unique_ptr<base::DictionaryValue> headers_;
+  net::HttpStatusCode status_code_;
+
+  // Lives on the UI thread.
+  std::unique_ptr<Reader> reader_;
+
+  // The chunk being read, and how much of it has been read.
+  scoped_refptr<base::RefCountedMemory> chunk_;
+  size_t chunk_offset_;
+  bool ended_;
+
+  // Saved arguments passed to ReadRawData while waiting for a chunk.
+  scoped_refptr<net::IOBuffer> pending_buffer_;
+  int pending_buffer_size_;
+
+  base::WeakPtrFactory<URLRequestStreamJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
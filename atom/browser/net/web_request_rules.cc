@@ -0,0 +1,236 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_rules.h"
+
+#include <set>
+
+#include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/net/url_pattern_index.h"
+#include "base/values.h"
+#include "content/public/browser/resource_request_info.h"
+#include "extensions/common/url_pattern.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_util.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+static_assert(content::RESOURCE_TYPE_LAST_TYPE < 31,
+              "ResourceType doesn't fit in the rule's bit set");
+
+// Set for requests without a ResourceRequestInfo, they are reported as
+// "other" to listeners.
+const uint32_t kNoResourceInfo = 1u << 31;
+
+struct ActionName {
+  const char* name;
+  WebRequestRules::Action action;
+};
+
+const ActionName kActionNames[] = {
+  { "block", WebRequestRules::ACTION_BLOCK },
+  { "redirect", WebRequestRules::ACTION_REDIRECT },
+  { "setRequestHeader", WebRequestRules::ACTION_SET_REQUEST_HEADER },
+  { "removeRequestHeader", WebRequestRules::ACTION_REMOVE_REQUEST_HEADER },
+  { "setResponseHeader", WebRequestRules::ACTION_SET_RESPONSE_HEADER },
+  { "removeResponseHeader", WebRequestRules::ACTION_REMOVE_RESPONSE_HEADER },
+};
+
+bool GetAction(const std::string& name, WebRequestRules::Action* action) {
+  for (const auto& entry : kActionNames) {
+    if (name == entry.name) {
+      *action = entry.action;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Converts the resource type |name| used in details objects to the bits of
+// the matching content::ResourceType values.
+bool GetResourceTypeBits(const std::string& name, uint32_t* bits) {
+  uint32_t result = name == "other" ? kNoResourceInfo : 0;
+  for (int type = 0; type < content::RESOURCE_TYPE_LAST_TYPE; ++type) {
+    if (name == ResourceTypeToString(static_cast<content::ResourceType>(type)))
+      result |= 1u << type;
+  }
+  if (!result)
+    return false;
+  *bits |= result;
+  return true;
+}
+
+}  // namespace
+
+WebRequestRules::Rule::Rule() : action(ACTION_BLOCK), resource_types(0) {
+}
+
+WebRequestRules::Rule::Rule(const Rule& other) = default;
+
+WebRequestRules::Rule::~Rule() {
+}
+
+// static
+std::unique_ptr<WebRequestRules> WebRequestRules::Create(
+    const base::ListValue& rules,
+    std::string* error) {
+  std::unique_ptr<WebRequestRules> result(new WebRequestRules);
+  for (size_t i = 0; i < rules.GetSize(); ++i) {
+    const base::DictionaryValue* dict;
+    if (!rules.GetDictionary(i, &dict)) {
+      *error = "Rule must be an object";
+      return nullptr;
+    }
+
+    Rule rule;
+    std::string action;
+    if (!dict->GetString("action", &action) || !GetAction(action,
+                                                          &rule.action)) {
+      *error = "Unknown rule action: " + action;
+      return nullptr;
+    }
+
+    std::set<URLPattern> patterns;
+    const base::ListValue* urls;
+    if (dict->GetList("urls", &urls)) {
+      for (size_t j = 0; j < urls->GetSize(); ++j) {
+        std::string url;
+        URLPattern pattern(URLPattern::SCHEME_ALL);
+        if (!urls->GetString(j, &url) ||
+            pattern.Parse(url) != URLPattern::PARSE_SUCCESS) {
+          *error = "Invalid URL pattern: " + url;
+          return nullptr;
+        }
+        patterns.insert(pattern);
+      }
+    }
+    rule.url_patterns = std::make_shared<URLPatternIndex>(patterns);
+
+    const base::ListValue* resource_types;
+    if (dict->GetList("resourceTypes", &resource_types)) {
+      for (size_t j = 0; j < resource_types->GetSize(); ++j) {
+        std::string type;
+        if (!resource_types->GetString(j, &type) ||
+            !GetResourceTypeBits(type, &rule.resource_types)) {
+          *error = "Unknown resource type: " + type;
+          return nullptr;
+        }
+      }
+    }
+
+    switch (rule.action) {
+      case ACTION_BLOCK:
+        break;
+      case ACTION_REDIRECT: {
+        std::string url;
+        dict->GetString("redirectURL", &url);
+        rule.redirect_url = GURL(url);
+        if (!rule.redirect_url.is_valid()) {
+          *error = "Invalid redirectURL: " + url;
+          return nullptr;
+        }
+        break;
+      }
+      case ACTION_SET_REQUEST_HEADER:
+      case ACTION_SET_RESPONSE_HEADER:
+        if (!dict->GetString("value", &rule.header_value) ||
+            !net::HttpUtil::IsValidHeaderValue(rule.header_value)) {
+          *error = "Invalid header value: " + rule.header_value;
+          return nullptr;
+        }
+        // Fall through.
+      case ACTION_REMOVE_REQUEST_HEADER:
+      case ACTION_REMOVE_RESPONSE_HEADER:
+        if (!dict->GetString("name", &rule.header_name) ||
+            !net::HttpUtil::IsValidHeaderName(rule.header_name)) {
+          *error = "Invalid header name: " + rule.header_name;
+          return nullptr;
+        }
+        break;
+    }
+
+    result->rules_.push_back(rule);
+  }
+  return result;
+}
+
+WebRequestRules::WebRequestRules() {
+}
+
+WebRequestRules::~WebRequestRules() {
+}
+
+bool WebRequestRules::ShouldBlock(net::URLRequest* request) const {
+  for (const auto& rule : rules_) {
+    if (rule.action == ACTION_BLOCK && Matches(rule, request))
+      return true;
+  }
+  return false;
+}
+
+bool WebRequestRules::GetRedirectURL(net::URLRequest* request,
+                                     GURL* new_url) const {
+  for (const auto& rule : rules_) {
+    // Don't redirect a request to itself again.
+    if (rule.action == ACTION_REDIRECT &&
+        rule.redirect_url != request->url() && Matches(rule, request)) {
+      *new_url = rule.redirect_url;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WebRequestRules::ApplyRequestHeaders(
+    net::URLRequest* request,
+    net::HttpRequestHeaders* headers) const {
+  for (const auto& rule : rules_) {
+    if (rule.action == ACTION_SET_REQUEST_HEADER && Matches(rule, request))
+      headers->SetHeader(rule.header_name, rule.header_value);
+    else if (rule.action == ACTION_REMOVE_REQUEST_HEADER &&
+             Matches(rule, request))
+      headers->RemoveHeader(rule.header_name);
+  }
+}
+
+void WebRequestRules::ApplyResponseHeaders(
+    net::URLRequest* request,
+    const net::HttpResponseHeaders* original_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_headers) const {
+  if (!original_headers)
+    return;
+
+  for (const auto& rule : rules_) {
+    if ((rule.action != ACTION_SET_RESPONSE_HEADER &&
+         rule.action != ACTION_REMOVE_RESPONSE_HEADER) ||
+        !Matches(rule, request))
+      continue;
+
+    // Copy the headers on the first change only.
+    if (!override_headers->get())
+      *override_headers =
+          new net::HttpResponseHeaders(original_headers->raw_headers());
+    (*override_headers)->RemoveHeader(rule.header_name);
+    if (rule.action == ACTION_SET_RESPONSE_HEADER)
+      (*override_headers)->AddHeader(
+          rule.header_name + ": " + rule.header_value);
+  }
+}
+
+bool WebRequestRules::Matches(const Rule& rule,
+                              net::URLRequest* request) const {
+  if (rule.resource_types) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    uint32_t bit = info ? 1u << info->GetResourceType() : kNoResourceInfo;
+    if (!(rule.resource_types & bit))
+      return false;
+  }
+  return rule.url_patterns->Matches(request->url());
+}
+
+}  // namespace atom
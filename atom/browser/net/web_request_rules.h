@@ -0,0 +1,93 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "url/gurl.h"
+
+namespace base {
+class ListValue;
+}
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+class URLRequest;
+}
+
+namespace atom {
+
+class URLPatternIndex;
+
+// Declarative webRequest rules that are evaluated on the IO thread, so the
+// requests they apply to never wait for a round trip to JavaScript.
+class WebRequestRules {
+ public:
+  enum Action {
+    ACTION_BLOCK,
+    ACTION_REDIRECT,
+    ACTION_SET_REQUEST_HEADER,
+    ACTION_REMOVE_REQUEST_HEADER,
+    ACTION_SET_RESPONSE_HEADER,
+    ACTION_REMOVE_RESPONSE_HEADER,
+  };
+
+  // Parses the rules passed to webRequest.setRules(), returns nullptr and
+  // sets |error| if any of them is invalid.
+  static std::unique_ptr<WebRequestRules> Create(const base::ListValue& rules,
+                                                 std::string* error);
+
+  ~WebRequestRules();
+
+  // Returns true if a rule blocks |request|.
+  bool ShouldBlock(net::URLRequest* request) const;
+
+  // Returns true and sets |new_url| if a rule redirects |request|.
+  bool GetRedirectURL(net::URLRequest* request, GURL* new_url) const;
+
+  // Applies the request header rules to |headers|.
+  void ApplyRequestHeaders(net::URLRequest* request,
+                           net::HttpRequestHeaders* headers) const;
+
+  // Applies the response header rules, |override_headers| is only set when a
+  // rule changes |original_headers|.
+  void ApplyResponseHeaders(
+      net::URLRequest* request,
+      const net::HttpResponseHeaders* original_headers,
+      scoped_refptr<net::HttpResponseHeaders>* override_headers) const;
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(const Rule& other);
+    ~Rule();
+
+    Action action;
+    std::shared_ptr<URLPatternIndex> url_patterns;
+    // Bit set of content::ResourceType, 0 matches all types.
+    uint32_t resource_types;
+    GURL redirect_url;
+    std::string header_name;
+    std::string header_value;
+  };
+
+  WebRequestRules();
+
+  bool Matches(const Rule& rule, net::URLRequest* request) const;
+
+  std::vector<Rule> rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebRequestRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
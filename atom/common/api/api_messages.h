@@ -25,10 +25,26 @@ IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync,
                            base::ListValue /* arguments */,
                            base::string16 /* result (in JSON) */)
 
+// Like AtomViewHostMsg_Message_Sync, but replied with a value serialized by
+// v8::ValueSerializer instead of JSON.
+IPC_SYNC_MESSAGE_ROUTED2_1(AtomViewHostMsg_Message_Sync_Serialized,
+                           base::string16 /* channel */,
+                           base::ListValue /* arguments */,
+                           std::vector<uint8_t> /* result */)
+
 IPC_MESSAGE_ROUTED2(AtomViewHostMsg_Message_Shared,
                     base::string16 /* channel */,
                     base::SharedMemoryHandle /* arguments */)
 
+// Shares the ring buffer the frame sends messages through, replacing the
+// previous one. See atom::SharedRingBuffer.
+IPC_MESSAGE_ROUTED2(AtomViewHostMsg_OpenRingBuffer,
+                    base::SharedMemoryHandle /* buffer */,
+                    uint32_t /* capacity */)
+
+// Messages were added to the frame's ring buffer.
+IPC_MESSAGE_ROUTED0(AtomViewHostMsg_RingBufferSignal)
+
 IPC_MESSAGE_ROUTED2(AtomViewMsg_Message,
                     base::string16 /* channel */,
                     base::ListValue /* arguments */)
@@ -40,8 +56,17 @@ IPC_MESSAGE_ROUTED2(AtomViewMsg_Message_Shared,
 // Update renderer process preferences.
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdatePreferences, base::ListValue)
 
-// Update renderer content settings
-IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
+// Replace all renderer content settings.
+IPC_MESSAGE_CONTROL2(AtomMsg_UpdateContentSettings,
+                     base::DictionaryValue /* content settings */,
+                     int /* version */)
+
+// Update the content types that changed since |base version|, content types
+// set to null are removed.
+IPC_MESSAGE_CONTROL3(AtomMsg_UpdateContentSettingsDelta,
+                     int /* base version */,
+                     int /* version */,
+                     base::DictionaryValue /* changed content types */)
 
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
@@ -9,6 +9,7 @@
 #include "atom_natives.h"  // NOLINT: This file is generated with coffee2c.
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/archive_registry.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
@@ -64,6 +65,10 @@ class Archive : public mate::Wrappable<Archive> {
     dict.Set("size", info.size);
     dict.Set("unpacked", info.unpacked);
     dict.Set("offset", info.offset);
+    if (info.encoding == asar::Archive::ENCODING_GZIP) {
+      dict.Set("encoding", "gzip");
+      dict.Set("compressedSize", info.compressed_size);
+    }
     return dict.GetHandle();
   }
 
@@ -153,11 +158,34 @@ void InitAsarSupport(v8::Isolate* isolate,
   }
 }
 
+// Returns the counters of the process-wide archive registry.
+v8::Local<v8::Value> GetArchiveRegistryStats(v8::Isolate* isolate) {
+  asar::ArchiveRegistry::Stats stats =
+      asar::ArchiveRegistry::GetInstance()->GetStats();
+  mate::Dictionary dict(isolate, v8::Object::New(isolate));
+  dict.Set("hits", static_cast<double>(stats.hits));
+  dict.Set("misses", static_cast<double>(stats.misses));
+  dict.Set("evictions", static_cast<double>(stats.evictions));
+  dict.Set("openArchives", static_cast<double>(stats.open_archives));
+  dict.Set("bytesMapped", static_cast<double>(stats.bytes_mapped));
+  dict.Set("openFds", static_cast<double>(stats.open_fds));
+  return dict.GetHandle();
+}
+
+// Closes the archives in the registry that are unused and have been idle for
+// |idle_seconds|.
+void EvictIdleArchives(double idle_seconds) {
+  asar::ArchiveRegistry::GetInstance()->EvictIdle(
+      base::TimeDelta::FromSecondsD(idle_seconds));
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createArchive", &Archive::Create);
   dict.SetMethod("initAsarSupport", &InitAsarSupport);
+  dict.SetMethod("getArchiveRegistryStats", &GetArchiveRegistryStats);
+  dict.SetMethod("evictIdleArchives", &EvictIdleArchives);
 }
 
 }  // namespace
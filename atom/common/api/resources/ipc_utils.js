@@ -16,12 +16,26 @@ if (!ipcRenderer) {
     return ipc.sendShared(channel, shared)
   }
 
+  // Returns false when the message doesn't fit in the buffer right now
+  ipcRenderer.sendRing = function () {
+    var args
+    args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
+    return ipc.sendRing(args)
+  }
+
   ipcRenderer.sendSync = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
     return $JSON.parse(ipc.sendSync('ipc-message-sync', $Array.slice(args)))
   }
 
+  // Like sendSync, but the reply keeps binary data and isn't limited to JSON
+  ipcRenderer.sendSyncSerialized = function () {
+    var args
+    args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
+    return ipc.sendSyncSerialized('ipc-message-sync-serialized', $Array.slice(args))
+  }
+
   ipcRenderer.sendToHost = function () {
     var args
     args = 1 <= arguments.length ? $Array.slice(arguments, 0) : []
@@ -55,7 +69,9 @@ exports.$set('on', ipcRenderer.on.bind(ipcRenderer))
 exports.$set('once', ipcRenderer.once.bind(ipcRenderer))
 exports.$set('send', ipcRenderer.send.bind(ipcRenderer))
 exports.$set('sendSync', ipcRenderer.sendSync.bind(ipcRenderer))
+exports.$set('sendSyncSerialized', ipcRenderer.sendSyncSerialized.bind(ipcRenderer))
 exports.$set('sendShared', ipcRenderer.sendShared.bind(ipcRenderer))
+exports.$set('sendRing', ipcRenderer.sendRing.bind(ipcRenderer))
 exports.$set('sendToHost', ipcRenderer.sendToHost.bind(ipcRenderer))
 exports.$set('emit', ipcRenderer.emit.bind(ipcRenderer))
 
@@ -0,0 +1,190 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/api/shared_ring_buffer.h"
+
+#include <string.h>
+
+#include <atomic>
+#include <utility>
+
+#include "base/bits.h"
+#include "base/memory/shared_memory.h"
+
+namespace atom {
+
+namespace {
+
+// Marks the unused end of the buffer, the next record starts at offset 0.
+const uint32_t kWrapMarker = 0xFFFFFFFF;
+
+const uint32_t kRecordAlignment = sizeof(uint32_t);
+
+uint32_t GetRecordSize(uint32_t size) {
+  return sizeof(uint32_t) +
+      static_cast<uint32_t>(base::bits::Align(size, kRecordAlignment));
+}
+
+}  // namespace
+
+struct SharedRingBuffer::Header {
+  // Positions only ever grow and wrap around at 2^32, which is why the
+  // capacity is a power of two.
+  std::atomic<uint32_t> write;
+  std::atomic<uint32_t> read;
+  // Set by the producer when it signaled the consumer, cleared by the
+  // consumer before it drains the buffer.
+  std::atomic<uint32_t> signal_pending;
+  uint32_t padding;
+};
+
+// static
+size_t SharedRingBuffer::GetMemorySize(uint32_t capacity) {
+  return sizeof(Header) + capacity;
+}
+
+// static
+bool SharedRingBuffer::IsValidCapacity(uint32_t capacity) {
+  return capacity >= kRecordAlignment && base::bits::IsPowerOfTwo(capacity);
+}
+
+// static
+std::unique_ptr<SharedRingBuffer> SharedRingBuffer::CreateProducer(
+    std::unique_ptr<base::SharedMemory> memory, uint32_t capacity) {
+  if (!memory || !IsValidCapacity(capacity) ||
+      !memory->Map(GetMemorySize(capacity)))
+    return nullptr;
+
+  std::unique_ptr<SharedRingBuffer> buffer(
+      new SharedRingBuffer(std::move(memory), capacity));
+  Header* header = buffer->header();
+  header->write.store(0);
+  header->read.store(0);
+  header->signal_pending.store(0);
+  return buffer;
+}
+
+// static
+std::unique_ptr<SharedRingBuffer> SharedRingBuffer::OpenConsumer(
+    const base::SharedMemoryHandle& handle, uint32_t capacity) {
+  if (!handle.IsValid() || !IsValidCapacity(capacity) ||
+      handle.GetSize() < GetMemorySize(capacity))
+    return nullptr;
+
+  std::unique_ptr<base::SharedMemory> memory(
+      new base::SharedMemory(handle, false));
+  if (!memory->Map(GetMemorySize(capacity)))
+    return nullptr;
+
+  std::unique_ptr<SharedRingBuffer> buffer(
+      new SharedRingBuffer(std::move(memory), capacity));
+  buffer->read_ = buffer->header()->read.load();
+  return buffer;
+}
+
+SharedRingBuffer::SharedRingBuffer(std::unique_ptr<base::SharedMemory> memory,
+                                   uint32_t capacity)
+    : memory_(std::move(memory)),
+      capacity_(capacity),
+      read_(0),
+      broken_(false) {
+}
+
+SharedRingBuffer::~SharedRingBuffer() {
+}
+
+base::SharedMemoryHandle SharedRingBuffer::ShareHandle() const {
+  return memory_->handle().Duplicate();
+}
+
+bool SharedRingBuffer::Write(const uint8_t* bytes,
+                             size_t size,
+                             bool* needs_signal) {
+  *needs_signal = false;
+  if (size >= capacity_)
+    return false;
+
+  Header* header = this->header();
+  uint32_t write = header->write.load(std::memory_order_relaxed);
+  uint32_t used = write - header->read.load(std::memory_order_acquire);
+  if (used > capacity_)
+    return false;
+
+  uint32_t record_size = GetRecordSize(static_cast<uint32_t>(size));
+  uint32_t offset = write & (capacity_ - 1);
+  uint32_t tail = capacity_ - offset;
+  // Records are never split, skip the end of the buffer if it doesn't fit.
+  uint32_t needed = record_size + (tail < record_size ? tail : 0);
+  if (record_size > capacity_ || needed > capacity_ - used)
+    return false;
+
+  if (tail < record_size) {
+    memcpy(data() + offset, &kWrapMarker, sizeof(kWrapMarker));
+    write += tail;
+    offset = 0;
+  }
+
+  uint32_t length = static_cast<uint32_t>(size);
+  memcpy(data() + offset, &length, sizeof(length));
+  memcpy(data() + offset + sizeof(length), bytes, size);
+  header->write.store(write + record_size);
+
+  *needs_signal = header->signal_pending.exchange(1) == 0;
+  return true;
+}
+
+void SharedRingBuffer::ClearSignal() {
+  header()->signal_pending.store(0);
+}
+
+bool SharedRingBuffer::Read(std::vector<uint8_t>* record) {
+  Header* header = this->header();
+  while (!broken_) {
+    uint32_t write = header->write.load();
+    uint32_t available = write - read_;
+    if (available == 0)
+      return false;
+    if (available > capacity_)
+      break;
+
+    uint32_t offset = read_ & (capacity_ - 1);
+    uint32_t tail = capacity_ - offset;
+    // The producer keeps records aligned, so the length is always in bounds.
+    if (tail < sizeof(uint32_t))
+      break;
+
+    uint32_t length;
+    memcpy(&length, data() + offset, sizeof(length));
+    if (length == kWrapMarker) {
+      if (tail > available)
+        break;
+      read_ += tail;
+      header->read.store(read_, std::memory_order_release);
+      continue;
+    }
+
+    if (length > tail - sizeof(length) ||
+        GetRecordSize(length) > available)
+      break;
+
+    const uint8_t* start = data() + offset + sizeof(length);
+    record->assign(start, start + length);
+    read_ += GetRecordSize(length);
+    header->read.store(read_, std::memory_order_release);
+    return true;
+  }
+
+  broken_ = true;
+  return false;
+}
+
+SharedRingBuffer::Header* SharedRingBuffer::header() const {
+  return static_cast<Header*>(memory_->memory());
+}
+
+uint8_t* SharedRingBuffer::data() const {
+  return static_cast<uint8_t*>(memory_->memory()) + sizeof(Header);
+}
+
+}  // namespace atom
@@ -0,0 +1,90 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_API_SHARED_RING_BUFFER_H_
+#define ATOM_COMMON_API_SHARED_RING_BUFFER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/shared_memory_handle.h"
+
+namespace base {
+class SharedMemory;
+}
+
+namespace atom {
+
+// A queue of messages in shared memory with one producer and one consumer,
+// which stays mapped for its whole lifetime.
+//
+// The producer appends length prefixed records and publishes them by moving
+// the write position, the consumer copies them out and moves the read
+// position. A flag in the header tells the producer when the consumer has to
+// be woken up, so only the first message after the consumer drained the
+// buffer needs a signal over IPC.
+//
+// The consumer doesn't trust anything in the shared memory, a producer that
+// writes garbage only breaks its own buffer.
+class SharedRingBuffer {
+ public:
+  // Size of the shared memory holding |capacity| bytes of records.
+  static size_t GetMemorySize(uint32_t capacity);
+
+  // Whether |capacity| can be used, it has to be a power of two.
+  static bool IsValidCapacity(uint32_t capacity);
+
+  // Takes |memory| of at least GetMemorySize(capacity) and sets it up for
+  // writing. Returns nullptr if it can't be mapped.
+  static std::unique_ptr<SharedRingBuffer> CreateProducer(
+      std::unique_ptr<base::SharedMemory> memory, uint32_t capacity);
+
+  // Maps the buffer created by the producer for reading.
+  static std::unique_ptr<SharedRingBuffer> OpenConsumer(
+      const base::SharedMemoryHandle& handle, uint32_t capacity);
+
+  ~SharedRingBuffer();
+
+  uint32_t capacity() const { return capacity_; }
+
+  // Returns a handle to share the buffer with the consumer.
+  base::SharedMemoryHandle ShareHandle() const;
+
+  // Producer: appends a record, returns false if there is no room for it.
+  // |needs_signal| is set when the consumer has to be told about it.
+  bool Write(const uint8_t* bytes, size_t size, bool* needs_signal);
+
+  // Consumer: called before draining the buffer in response to a signal.
+  void ClearSignal();
+
+  // Consumer: copies the next record into |record|. Returns false when the
+  // buffer is empty or broken.
+  bool Read(std::vector<uint8_t>* record);
+
+ private:
+  struct Header;
+
+  SharedRingBuffer(std::unique_ptr<base::SharedMemory> memory,
+                   uint32_t capacity);
+
+  Header* header() const;
+  uint8_t* data() const;
+
+  std::unique_ptr<base::SharedMemory> memory_;
+  const uint32_t capacity_;
+
+  // Consumer: the read position, the copy in the header is only for the
+  // producer.
+  uint32_t read_;
+  bool broken_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedRingBuffer);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_API_SHARED_RING_BUFFER_H_
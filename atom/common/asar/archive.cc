@@ -8,13 +8,15 @@
 #include <utility>
 #include <vector>
 
+#include "atom/common/asar/asar_util.h"
+#include "atom/common/asar/extraction_cache.h"
 #include "atom/common/asar/scoped_temporary_file.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/pickle.h"
-#include "base/strings/string_number_conversions.h"
 #include "base/values.h"
 
 #if defined(OS_WIN)
@@ -27,91 +29,23 @@ namespace asar {
 
 namespace {
 
-#if defined(OS_WIN)
-const char kSeparators[] = "\\/";
-#else
-const char kSeparators[] = "/";
-#endif
-
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
-
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
-
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
-}
+bool FillFileInfoWithEntry(Archive::FileInfo* info,
+                           const HeaderIndex::Entry& entry) {
+  if (!(entry.flags & HeaderIndex::FLAG_HAS_INFO))
+    return false;
+  info->size = entry.size;
 
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path == "") {
-    *out = root;
+  if (entry.flags & HeaderIndex::FLAG_UNPACKED) {
+    info->unpacked = true;
     return true;
   }
 
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
-
-    dir = child;
-    path.erase(0, delimiter_position + 1);
+  info->offset = entry.offset;
+  info->executable = (entry.flags & HeaderIndex::FLAG_EXECUTABLE) != 0;
+  if (entry.flags & HeaderIndex::FLAG_GZIP) {
+    info->encoding = Archive::ENCODING_GZIP;
+    info->compressed_size = entry.compressed_size;
   }
-
-  return GetChildNode(root, path, dir, out);
-}
-
-bool FillFileInfoWithNode(Archive::FileInfo* info,
-                          uint32_t header_size,
-                          const base::DictionaryValue* node) {
-  int size;
-  if (!node->GetInteger("size", &size))
-    return false;
-  info->size = static_cast<uint32_t>(size);
-
-  if (node->GetBoolean("unpacked", &info->unpacked) && info->unpacked)
-    return true;
-
-  std::string offset;
-  if (!node->GetString("offset", &offset))
-    return false;
-  if (!base::StringToUint64(offset, &info->offset))
-    return false;
-  info->offset += header_size;
-
-  node->GetBoolean("executable", &info->executable);
-
   return true;
 }
 
@@ -128,7 +62,8 @@ Archive::Archive(const base::FilePath& path)
 #else
       fd_(-1),
 #endif
-      header_size_(0) {
+      header_size_(0),
+      initialized_(false) {
 }
 
 Archive::~Archive() {
@@ -151,120 +86,150 @@ bool Archive::Init() {
     return false;
   }
 
+  std::string header;
+  uint32_t size;
+  if (!ReadHeader(&header, &size))
+    return false;
+
+  std::string error;
+  base::JSONReader reader;
+  std::unique_ptr<base::Value> value(reader.ReadToValue(header));
+  if (!value || !value->IsType(base::Value::Type::DICTIONARY)) {
+    LOG(ERROR) << "Failed to parse header: " << error;
+    return false;
+  }
+
+  // The parsed tree is only needed to compile the index, drop it right after.
+  header_size_ = 8 + size;
+  if (!index_.Build(*static_cast<base::DictionaryValue*>(value.get()),
+                    header_size_)) {
+    LOG(ERROR) << "Failed to index header of " << path_.value();
+    return false;
+  }
+
+  initialized_ = true;
+  return true;
+}
+
+base::DictionaryValue* Archive::header() {
+  if (!initialized_)
+    return nullptr;
+
+  base::AutoLock auto_lock(lock_);
+  if (!header_) {
+    std::string header;
+    uint32_t size;
+    if (!ReadHeader(&header, &size))
+      return nullptr;
+
+    std::unique_ptr<base::Value> value(base::JSONReader::Read(header));
+    if (!value || !value->IsType(base::Value::Type::DICTIONARY))
+      return nullptr;
+    header_.reset(static_cast<base::DictionaryValue*>(value.release()));
+  }
+  return header_.get();
+}
+
+bool Archive::ReadHeader(std::string* header, uint32_t* size) {
   std::vector<char> buf;
   int len;
 
   buf.resize(8);
-  len = file_.ReadAtCurrentPos(buf.data(), buf.size());
+  len = file_.Read(0, buf.data(), buf.size());
   if (len != static_cast<int>(buf.size())) {
     PLOG(ERROR) << "Failed to read header size from " << path_.value();
     return false;
   }
 
-  uint32_t size;
   if (!base::PickleIterator(base::Pickle(buf.data(), buf.size())).ReadUInt32(
-          &size)) {
+          size)) {
     LOG(ERROR) << "Failed to parse header size from " << path_.value();
     return false;
   }
 
-  buf.resize(size);
-  len = file_.ReadAtCurrentPos(buf.data(), buf.size());
+  buf.resize(*size);
+  len = file_.Read(8, buf.data(), buf.size());
   if (len != static_cast<int>(buf.size())) {
     PLOG(ERROR) << "Failed to read header from " << path_.value();
     return false;
   }
 
-  std::string header;
   if (!base::PickleIterator(base::Pickle(buf.data(), buf.size())).ReadString(
-        &header)) {
+        header)) {
     LOG(ERROR) << "Failed to parse header from " << path_.value();
     return false;
   }
 
-  std::string error;
-  base::JSONReader reader;
-  std::unique_ptr<base::Value> value(reader.ReadToValue(header));
-  if (!value || !value->IsType(base::Value::Type::DICTIONARY)) {
-    LOG(ERROR) << "Failed to parse header: " << error;
-    return false;
-  }
-
-  header_size_ = 8 + size;
-  header_.reset(static_cast<base::DictionaryValue*>(value.release()));
   return true;
 }
 
-bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
-    return false;
+uint32_t Archive::Lookup(const base::FilePath& path) const {
+  if (!initialized_)
+    return HeaderIndex::kNotFound;
+#if defined(OS_WIN)
+  return index_.Find(path.AsUTF8Unsafe());
+#else
+  return index_.Find(path.value());
+#endif
+}
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
+  uint32_t id = Lookup(path);
+  if (id == HeaderIndex::kNotFound)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+  const HeaderIndex::Entry& entry = index_.entry(id);
+  if (entry.type == HeaderIndex::Type::LINK) {
+    return GetFileInfo(
+        base::FilePath::FromUTF8Unsafe(index_.LinkTarget(entry)), info);
+  }
 
-  return FillFileInfoWithNode(info, header_size_, node);
+  return FillFileInfoWithEntry(info, entry);
 }
 
 bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
-    return false;
-
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  uint32_t id = Lookup(path);
+  if (id == HeaderIndex::kNotFound)
     return false;
 
-  if (node->HasKey("link")) {
+  const HeaderIndex::Entry& entry = index_.entry(id);
+  if (entry.type == HeaderIndex::Type::LINK) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->HasKey("files")) {
+  if (entry.type == HeaderIndex::Type::DIRECTORY) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  return FillFileInfoWithEntry(stats, entry);
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
+  uint32_t id = index_.ResolveDirectory(Lookup(path));
+  if (id == HeaderIndex::kNotFound)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
-
-  const base::DictionaryValue* files;
-  if (!GetFilesNode(header_.get(), node, &files))
-    return false;
-
-  base::DictionaryValue::Iterator iter(*files);
-  while (!iter.IsAtEnd()) {
-    list->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
-  }
+  const HeaderIndex::Entry& dir = index_.entry(id);
+  list->reserve(list->size() + dir.count);
+  for (uint32_t i = dir.first; i < dir.first + dir.count; ++i)
+    list->push_back(base::FilePath::FromUTF8Unsafe(
+        index_.Name(index_.entry(i))));
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
-    return false;
-
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  uint32_t id = Lookup(path);
+  if (id == HeaderIndex::kNotFound)
     return false;
 
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  const HeaderIndex::Entry& entry = index_.entry(id);
+  if (entry.type == HeaderIndex::Type::LINK) {
+    *realpath = base::FilePath::FromUTF8Unsafe(index_.LinkTarget(entry));
     return true;
   }
 
@@ -273,12 +238,24 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
 }
 
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
-  auto it = external_files_.find(path.value());
-  if (it != external_files_.end()) {
-    *out = it->second->path();
-    return true;
+  {
+    base::AutoLock auto_lock(lock_);
+    auto it = external_files_.find(path.value());
+    if (it != external_files_.end()) {
+      *out = it->second->path();
+      return true;
+    }
+
+    auto cached = cached_files_.find(path.value());
+    if (cached != cached_files_.end()) {
+      *out = cached->second;
+      return true;
+    }
   }
 
+  // The file is copied out without holding the lock, so other threads can
+  // keep using the archive. Reads of |file_| are positional and the index is
+  // immutable, if two threads copy the same file the first one is kept.
   FileInfo info;
   if (!GetFileInfo(path, &info))
     return false;
@@ -288,10 +265,27 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
     return true;
   }
 
-  std::unique_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
   base::FilePath::StringType ext = path.Extension();
-  if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
-    return false;
+  std::unique_ptr<ScopedTemporaryFile> temp_file(new ScopedTemporaryFile);
+  if (info.encoding != ENCODING_NONE) {
+    // Compressed files are inflated into a temporary file.
+    base::StringPiece stored;
+    std::string contents;
+    if (!GetMappedContents(info, &stored) ||
+        !GzipUncompressToString(stored, info.size, &contents) ||
+        !temp_file->InitFromContents(ext, contents))
+      return false;
+  } else {
+    if (ExtractToCache(path_, &file_, ext, info.offset, info.size,
+                       info.executable, out)) {
+      base::AutoLock auto_lock(lock_);
+      cached_files_.insert(std::make_pair(path.value(), *out));
+      return true;
+    }
+
+    if (!temp_file->InitFromFile(&file_, ext, info.offset, info.size))
+      return false;
+  }
 
 #if defined(OS_POSIX)
   if (info.executable) {
@@ -300,8 +294,11 @@ bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
   }
 #endif
 
-  *out = temp_file->path();
-  external_files_[path.value()] = std::move(temp_file);
+  base::AutoLock auto_lock(lock_);
+  auto inserted = external_files_.insert(
+      std::make_pair(path.value(), std::move(temp_file)));
+  // A copy made by another thread meanwhile wins, ours is deleted.
+  *out = inserted.first->second->path();
   return true;
 }
 
@@ -309,4 +306,79 @@ int Archive::GetFD() const {
   return fd_;
 }
 
+bool Archive::EnsureMapped() {
+  base::AutoLock auto_lock(lock_);
+  return EnsureMappedLocked();
+}
+
+bool Archive::GetMappedContents(const base::FilePath& path,
+                                base::StringPiece* contents) {
+  FileInfo info;
+  if (!GetFileInfo(path, &info))
+    return false;
+  return GetMappedContents(info, contents);
+}
+
+bool Archive::GetMappedContents(const FileInfo& info,
+                                base::StringPiece* contents) {
+  base::AutoLock auto_lock(lock_);
+  return GetMappedContentsLocked(info, contents);
+}
+
+bool Archive::EnsureMappedLocked() {
+  lock_.AssertAcquired();
+  if (mapped_file_)
+    return true;
+
+  if (!file_.IsValid())
+    return false;
+
+  std::unique_ptr<base::MemoryMappedFile> mapped_file(
+      new base::MemoryMappedFile);
+  if (!mapped_file->Initialize(file_.Duplicate())) {
+    LOG(WARNING) << "Failed to map " << path_.value();
+    return false;
+  }
+
+  mapped_file_ = std::move(mapped_file);
+  return true;
+}
+
+bool Archive::GetMappedContentsLocked(const FileInfo& info,
+                                      base::StringPiece* contents) {
+  if (info.unpacked || !EnsureMappedLocked())
+    return false;
+
+  if (info.offset > mapped_file_->length() ||
+      info.stored_size() > mapped_file_->length() - info.offset) {
+    LOG(ERROR) << "Entry at " << info.offset << " is out of bounds in "
+               << path_.value();
+    return false;
+  }
+
+  // Pages of the mapping past the end of the file fault when they are read.
+  int64_t file_length = file_.GetLength();
+  if (file_length < 0 ||
+      static_cast<uint64_t>(file_length) < info.offset + info.stored_size()) {
+    LOG(ERROR) << path_.value() << " has been truncated since it was mapped";
+    return false;
+  }
+
+  *contents = base::StringPiece(
+      reinterpret_cast<const char*>(mapped_file_->data()) + info.offset,
+      info.stored_size());
+  return true;
+}
+
+size_t Archive::GetMappedLength() {
+  base::AutoLock auto_lock(lock_);
+  return mapped_file_ ? mapped_file_->length() : 0;
+}
+
+int Archive::GetOpenFileCount() {
+  base::AutoLock auto_lock(lock_);
+  // The mapping keeps its own duplicate of the file open.
+  return (file_.IsValid() ? 1 : 0) + (mapped_file_ ? 1 : 0);
+}
+
 }  // namespace asar
@@ -6,14 +6,19 @@
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "atom/common/asar/header_index.h"
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 
 namespace base {
 class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
@@ -24,12 +29,26 @@ class ScopedTemporaryFile;
 // information from it.
 class Archive {
  public:
+  enum Encoding {
+    ENCODING_NONE,
+    ENCODING_GZIP,
+  };
+
   struct FileInfo {
-    FileInfo() : unpacked(false), executable(false), size(0), offset(0) {}
+    FileInfo() : unpacked(false), executable(false), size(0), offset(0),
+                 encoding(ENCODING_NONE), compressed_size(0) {}
+
+    // Number of bytes the file takes in the archive.
+    uint32_t stored_size() const {
+      return encoding == ENCODING_NONE ? size : compressed_size;
+    }
+
     bool unpacked;
     bool executable;
     uint32_t size;
     uint64_t offset;
+    Encoding encoding;
+    uint32_t compressed_size;
   };
 
   struct Stats : public FileInfo {
@@ -57,28 +76,78 @@ class Archive {
   // Fs.realpath(path).
   bool Realpath(const base::FilePath& path, base::FilePath* realpath);
 
-  // Copy the file into a temporary file, and return the new path.
+  // Copy the file into the extraction cache, or a temporary file if the cache
+  // is unavailable, and return the new path.
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
 
   // Returns the file's fd.
   int GetFD() const;
 
+  // Maps the whole archive read-only into memory, does nothing if it is
+  // already mapped. Must be called on a thread that allows IO.
+  bool EnsureMapped();
+
+  // Returns a view of the packed file at |path| in the mapped archive, mapping
+  // it first if needed. The view stays valid for the lifetime of the archive.
+  // Compressed files are returned as stored. Fails for unpacked files, and
+  // when the archive has been truncated below the file since it was mapped,
+  // as reading the view would then fault. Must be called on a thread that
+  // allows IO.
+  bool GetMappedContents(const base::FilePath& path,
+                         base::StringPiece* contents);
+  bool GetMappedContents(const FileInfo& info, base::StringPiece* contents);
+
+  // Returns the number of bytes currently mapped.
+  size_t GetMappedLength();
+
+  // Returns the number of file descriptors held by the archive.
+  int GetOpenFileCount();
+
   base::FilePath path() const { return path_; }
-  base::DictionaryValue* header() const { return header_.get(); }
+
+  // Returns the parsed JSON header, it is only built on first use since all
+  // lookups go through the compiled index.
+  base::DictionaryValue* header();
 
  private:
+  // Reads the JSON header string from the file, |size| is the size of the
+  // pickled header.
+  bool ReadHeader(std::string* header, uint32_t* size);
+
+  // Same as EnsureMapped() and GetMappedContents() with |lock_| held.
+  bool EnsureMappedLocked();
+  bool GetMappedContentsLocked(const FileInfo& info,
+                               base::StringPiece* contents);
+
+  // Returns the id of |path| in the index, or HeaderIndex::kNotFound.
+  uint32_t Lookup(const base::FilePath& path) const;
+
   base::FilePath path_;
   base::File file_;
   int fd_;
   uint32_t header_size_;
+  bool initialized_;
+  HeaderIndex index_;
+  // Archives are shared between threads, the lock guards the state below
+  // that is created lazily. The index above is immutable after Init().
+  base::Lock lock_;
+
   std::unique_ptr<base::DictionaryValue> header_;
 
+  // Read-only mapping of the archive, created on first use. The mapping
+  // itself is immutable once created.
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+
   // Cached external temporary files.
   std::unordered_map
     <base::FilePath::StringType, std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
 
+  // Files extracted into the persistent extraction cache.
+  std::unordered_map<base::FilePath::StringType, base::FilePath>
+      cached_files_;
+
   DISALLOW_COPY_AND_ASSIGN(Archive);
 };
 
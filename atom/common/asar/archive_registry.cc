@@ -0,0 +1,153 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/archive_registry.h"
+
+#include <functional>
+
+#include "atom/common/asar/archive.h"
+#include "base/lazy_instance.h"
+
+namespace asar {
+
+namespace {
+
+// Unused archives are closed after being idle for this long.
+const int kIdleTimeSeconds = 5 * 60;
+
+// Maximum number of archives kept open by each shard.
+const size_t kMaxArchivesPerShard = 8;
+
+// The global instance of ArchiveRegistry, will be destroyed on exit.
+base::LazyInstance<ArchiveRegistry>::DestructorAtExit g_archive_registry =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+ArchiveRegistry::Stats::Stats()
+    : hits(0),
+      misses(0),
+      evictions(0),
+      open_archives(0),
+      bytes_mapped(0),
+      open_fds(0) {
+}
+
+ArchiveRegistry::Shard::Shard() : hits(0), misses(0), evictions(0) {
+}
+
+ArchiveRegistry::Shard::~Shard() {
+}
+
+// static
+ArchiveRegistry* ArchiveRegistry::GetInstance() {
+  return g_archive_registry.Pointer();
+}
+
+ArchiveRegistry::ArchiveRegistry() {
+}
+
+ArchiveRegistry::~ArchiveRegistry() {
+}
+
+std::shared_ptr<Archive> ArchiveRegistry::GetOrCreate(
+    const base::FilePath& path) {
+  Shard* shard = GetShard(path);
+  {
+    base::AutoLock auto_lock(shard->lock);
+    auto it = shard->archives.find(path);
+    if (it != shard->archives.end()) {
+      ++shard->hits;
+      it->second.last_used = base::TimeTicks::Now();
+      return it->second.archive;
+    }
+    ++shard->misses;
+  }
+
+  // Open the archive without holding the lock, other threads may keep using
+  // the archives of this shard meanwhile.
+  std::shared_ptr<Archive> archive(new Archive(path));
+  if (!archive->Init())
+    return nullptr;
+
+  std::vector<std::shared_ptr<Archive>> evicted;
+  base::AutoLock auto_lock(shard->lock);
+  base::TimeTicks now = base::TimeTicks::Now();
+  Entry& entry = shard->archives[path];
+  // Another thread may have opened the same archive first.
+  if (!entry.archive)
+    entry.archive = archive;
+  entry.last_used = now;
+  archive = entry.archive;
+
+  EvictLocked(shard, now, base::TimeDelta::FromSeconds(kIdleTimeSeconds),
+              &evicted);
+  return archive;
+}
+
+void ArchiveRegistry::EvictIdle(base::TimeDelta idle_time) {
+  for (Shard& shard : shards_) {
+    std::vector<std::shared_ptr<Archive>> evicted;
+    base::AutoLock auto_lock(shard.lock);
+    EvictLocked(&shard, base::TimeTicks::Now(), idle_time, &evicted);
+  }
+}
+
+void ArchiveRegistry::EvictExpired() {
+  EvictIdle(base::TimeDelta::FromSeconds(kIdleTimeSeconds));
+}
+
+ArchiveRegistry::Stats ArchiveRegistry::GetStats() {
+  Stats stats;
+  for (Shard& shard : shards_) {
+    base::AutoLock auto_lock(shard.lock);
+    stats.hits += shard.hits;
+    stats.misses += shard.misses;
+    stats.evictions += shard.evictions;
+    stats.open_archives += shard.archives.size();
+    for (const auto& it : shard.archives) {
+      stats.bytes_mapped += it.second.archive->GetMappedLength();
+      stats.open_fds += it.second.archive->GetOpenFileCount();
+    }
+  }
+  return stats;
+}
+
+ArchiveRegistry::Shard* ArchiveRegistry::GetShard(const base::FilePath& path) {
+  size_t hash = std::hash<base::FilePath::StringType>()(path.value());
+  return &shards_[hash % kShardCount];
+}
+
+void ArchiveRegistry::EvictLocked(
+    Shard* shard,
+    base::TimeTicks now,
+    base::TimeDelta idle_time,
+    std::vector<std::shared_ptr<Archive>>* evicted) {
+  shard->lock.AssertAcquired();
+
+  // Archives still referenced elsewhere can't be closed anyway.
+  auto lru = shard->archives.end();
+  for (auto it = shard->archives.begin(); it != shard->archives.end();) {
+    bool unused = it->second.archive.use_count() == 1;
+    if (unused && now - it->second.last_used >= idle_time) {
+      evicted->push_back(std::move(it->second.archive));
+      it = shard->archives.erase(it);
+      ++shard->evictions;
+      continue;
+    }
+    if (unused && (lru == shard->archives.end() ||
+                   it->second.last_used < lru->second.last_used))
+      lru = it;
+    ++it;
+  }
+
+  if (shard->archives.size() > kMaxArchivesPerShard &&
+      lru != shard->archives.end()) {
+    evicted->push_back(std::move(lru->second.archive));
+    shard->archives.erase(lru);
+    ++shard->evictions;
+  }
+}
+
+}  // namespace asar
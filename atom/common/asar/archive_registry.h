@@ -0,0 +1,95 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_ARCHIVE_REGISTRY_H_
+#define ATOM_COMMON_ASAR_ARCHIVE_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace asar {
+
+class Archive;
+
+// Process-wide cache of opened archives that can be used from any thread.
+//
+// Archives are spread over a fixed number of shards by path, each guarded by
+// its own lock, so lookups of different archives don't contend. Archives that
+// nobody else holds a reference to are closed once they have been idle for a
+// while, or when their shard is over capacity.
+class ArchiveRegistry {
+ public:
+  struct Stats {
+    Stats();
+
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t open_archives;
+    uint64_t bytes_mapped;
+    uint64_t open_fds;
+  };
+
+  static ArchiveRegistry* GetInstance();
+
+  ArchiveRegistry();
+  ~ArchiveRegistry();
+
+  // Returns the archive at |path|, opening it on first use.
+  std::shared_ptr<Archive> GetOrCreate(const base::FilePath& path);
+
+  // Closes all unused archives that have been idle for |idle_time|.
+  void EvictIdle(base::TimeDelta idle_time);
+
+  // Closes the unused archives that have been idle for longer than archives
+  // are normally kept. The browser process calls it periodically.
+  void EvictExpired();
+
+  Stats GetStats();
+
+ private:
+  struct Entry {
+    std::shared_ptr<Archive> archive;
+    base::TimeTicks last_used;
+  };
+
+  struct Shard {
+    Shard();
+    ~Shard();
+
+    base::Lock lock;
+    std::map<base::FilePath, Entry> archives;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+  };
+
+  static const size_t kShardCount = 16;
+
+  Shard* GetShard(const base::FilePath& path);
+
+  // Removes unused archives of |shard| idle for |idle_time| and then the
+  // least recently used ones over capacity, moving them to |evicted| so they
+  // can be closed after the lock is released. |shard->lock| must be held.
+  void EvictLocked(Shard* shard,
+                   base::TimeTicks now,
+                   base::TimeDelta idle_time,
+                   std::vector<std::shared_ptr<Archive>>* evicted);
+
+  Shard shards_[kShardCount];
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveRegistry);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_ARCHIVE_REGISTRY_H_
@@ -4,37 +4,58 @@
 
 #include "atom/common/asar/asar_util.h"
 
-#include <map>
+#include <string.h>
+
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/archive_registry.h"
+#include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
-#include "base/lazy_instance.h"
-#include "base/stl_util.h"
+#include "third_party/zlib/zlib.h"
+
+#if defined(OS_LINUX)
+#include <sys/sendfile.h>
+
+#include "base/posix/eintr_wrapper.h"
+#endif
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
-typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-static base::LazyInstance<ArchiveMap>::DestructorAtExit g_archive_map =
-    LAZY_INSTANCE_INITIALIZER;
-
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
+// Size of the buffer used when copying files out of archives.
+const size_t kCopyChunkSize = 256 * 1024;
+
+#if defined(OS_LINUX)
+// Copies the range in the kernel, returns false if sendfile() is not
+// supported between these files so the caller can fall back.
+bool SendFileRange(base::File* src, uint64_t offset, uint64_t size,
+                   base::File* dest, uint64_t* copied) {
+  off_t src_offset = static_cast<off_t>(offset);
+  while (*copied < size) {
+    size_t chunk = static_cast<size_t>(
+        std::min<uint64_t>(size - *copied, kCopyChunkSize * 16));
+    ssize_t rv = HANDLE_EINTR(sendfile(dest->GetPlatformFile(),
+                                       src->GetPlatformFile(),
+                                       &src_offset, chunk));
+    if (rv <= 0)
+      return false;
+    *copied += rv;
+  }
+  return true;
+}
+#endif
+
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  ArchiveMap& archive_map = *g_archive_map.Pointer();
-  if (!ContainsKey(archive_map, path)) {
-    std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
-      return nullptr;
-    archive_map[path] = archive;
-  }
-  return archive_map[path];
+  return ArchiveRegistry::GetInstance()->GetOrCreate(path);
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
@@ -79,13 +100,79 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
+  // Packed files are copied or inflated straight out of the archive's mapping.
+  base::StringPiece mapped;
+  if (archive->GetMappedContents(info, &mapped)) {
+    if (info.encoding == Archive::ENCODING_GZIP)
+      return GzipUncompressToString(mapped, info.size, contents);
+    mapped.CopyToString(contents);
+    return true;
+  }
+
   base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
   if (!src.IsValid())
     return false;
 
-  contents->resize(info.size);
-  return static_cast<int>(info.size) == src.Read(
-      info.offset, const_cast<char*>(contents->data()), contents->size());
+  std::string stored;
+  std::string* buffer =
+      info.encoding == Archive::ENCODING_NONE ? contents : &stored;
+  buffer->resize(info.stored_size());
+  if (static_cast<int>(info.stored_size()) != src.Read(
+      info.offset, const_cast<char*>(buffer->data()), buffer->size()))
+    return false;
+
+  if (info.encoding == Archive::ENCODING_GZIP)
+    return GzipUncompressToString(stored, info.size, contents);
+  return true;
+}
+
+bool GzipUncompressToString(const base::StringPiece& compressed,
+                            uint32_t size,
+                            std::string* contents) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  // Accept only the gzip wrapper.
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+    return false;
+
+  contents->resize(size);
+  stream.next_in = reinterpret_cast<Bytef*>(
+      const_cast<char*>(compressed.data()));
+  stream.avail_in = static_cast<uInt>(compressed.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&(*contents)[0]);
+  stream.avail_out = static_cast<uInt>(size);
+
+  int rv = inflate(&stream, Z_FINISH);
+  uLong total_out = stream.total_out;
+  inflateEnd(&stream);
+  if (rv != Z_STREAM_END || total_out != size) {
+    contents->clear();
+    return false;
+  }
+  return true;
+}
+
+bool CopyFileRange(base::File* src, uint64_t offset, uint64_t size,
+                   base::File* dest) {
+  uint64_t copied = 0;
+#if defined(OS_LINUX)
+  if (SendFileRange(src, offset, size, dest, &copied))
+    return true;
+#endif
+
+  std::vector<char> buf(static_cast<size_t>(
+      std::min<uint64_t>(size - copied, kCopyChunkSize)));
+  while (copied < size) {
+    int chunk = static_cast<int>(
+        std::min<uint64_t>(size - copied, buf.size()));
+    int len = src->Read(offset + copied, buf.data(), chunk);
+    if (len <= 0)
+      return false;
+    if (dest->WriteAtCurrentPos(buf.data(), len) != len)
+      return false;
+    copied += len;
+  }
+  return true;
 }
 
 }  // namespace asar
@@ -5,10 +5,15 @@
 #ifndef ATOM_COMMON_ASAR_ASAR_UTIL_H_
 #define ATOM_COMMON_ASAR_ASAR_UTIL_H_
 
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
+#include "base/strings/string_piece.h"
+
 namespace base {
+class File;
 class FilePath;
 }
 
@@ -16,7 +21,7 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+// Gets or creates a new Archive from the path, can be called on any thread.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
 // Separates the path to Archive out.
@@ -27,6 +32,17 @@ bool GetAsarArchivePath(const base::FilePath& full_path,
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
+// Inflates the gzip stream |compressed| into |contents|, which is expected to
+// be exactly |size| bytes.
+bool GzipUncompressToString(const base::StringPiece& compressed,
+                            uint32_t size,
+                            std::string* contents);
+
+// Copies |size| bytes at |offset| of |src| to the current position of |dest|
+// without buffering the whole range in memory.
+bool CopyFileRange(base::File* src, uint64_t offset, uint64_t size,
+                   base::File* dest);
+
 }  // namespace asar
 
 #endif  // ATOM_COMMON_ASAR_ASAR_UTIL_H_
@@ -0,0 +1,293 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/extraction_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "atom/common/asar/asar_util.h"
+#include "base/files/file.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/path_service.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_restrictions.h"
+#include "chrome/common/chrome_paths.h"
+#include "crypto/secure_hash.h"
+#include "crypto/sha2.h"
+
+namespace asar {
+
+namespace {
+
+const base::FilePath::CharType kExtractionCacheDirName[] =
+    FILE_PATH_LITERAL("AsarCache");
+
+// Next to every entry, holds the SHA-256 of its contents.
+const base::FilePath::CharType kHashExtension[] = FILE_PATH_LITERAL("sha256");
+
+// "<archive>.path" holds the path of the archive, so the entries of deleted
+// archives can be swept.
+const base::FilePath::CharType kArchivePathExtension[] =
+    FILE_PATH_LITERAL("path");
+
+// Number of bytes of the SHA-1 hashes kept in the name of a cache entry.
+const size_t kNameHashSize = 8;
+
+const size_t kHashChunkSize = 64 * 1024;
+
+// Cache entries are named "<archive>-<version>-<offset>_<size>", where
+// <archive> hashes the archive's path and <version> its size and modification
+// time, so the entries of an older version of an archive can be found by name.
+struct CacheKey {
+  std::string archive;
+  std::string version;
+};
+
+// The archive versions whose older entries have been evicted by this process.
+struct EvictedArchives {
+  base::Lock lock;
+  std::set<std::string> keys;
+};
+
+base::LazyInstance<EvictedArchives>::Leaky g_evicted_archives =
+    LAZY_INSTANCE_INITIALIZER;
+
+std::string HashForName(const std::string& value) {
+  std::string hash = base::SHA1HashString(value);
+  return base::ToLowerASCII(base::HexEncode(hash.data(), kNameHashSize));
+}
+
+CacheKey GetCacheKey(const base::FilePath& archive_path,
+                     const base::File::Info& archive_info) {
+  CacheKey key;
+  key.archive = HashForName(archive_path.AsUTF8Unsafe());
+  key.version = HashForName(
+      base::Int64ToString(archive_info.size) + '\n' +
+      base::Int64ToString(archive_info.last_modified.ToInternalValue()));
+  return key;
+}
+
+std::string GetEntryPrefix(const CacheKey& key) {
+  return key.archive + '-' + key.version + '-';
+}
+
+base::FilePath GetHashPath(const base::FilePath& path) {
+  return path.AddExtension(kHashExtension);
+}
+
+// Computes the hex SHA-256 of |size| bytes at |offset| of |file|.
+bool HashFileRange(base::File* file, uint64_t offset, uint64_t size,
+                   std::string* hash) {
+  std::unique_ptr<crypto::SecureHash> hasher(
+      crypto::SecureHash::Create(crypto::SecureHash::SHA256));
+  std::vector<char> buf(static_cast<size_t>(
+      std::min<uint64_t>(size, kHashChunkSize)));
+  uint64_t read = 0;
+  while (read < size) {
+    int chunk = static_cast<int>(std::min<uint64_t>(size - read, buf.size()));
+    int len = file->Read(offset + read, buf.data(), chunk);
+    if (len <= 0)
+      return false;
+    hasher->Update(buf.data(), len);
+    read += len;
+  }
+
+  uint8_t digest[crypto::kSHA256Length];
+  hasher->Finish(digest, sizeof(digest));
+  *hash = base::ToLowerASCII(base::HexEncode(digest, sizeof(digest)));
+  return true;
+}
+
+// Writes |contents| to |path| through a temporary file, so other processes
+// never see a partial write.
+bool WriteCacheFile(const base::FilePath& cache_dir,
+                    const base::FilePath& path,
+                    const std::string& contents) {
+  base::FilePath temp_path;
+  if (!base::CreateTemporaryFileInDir(cache_dir, &temp_path))
+    return false;
+  int size = static_cast<int>(contents.size());
+  if (base::WriteFile(temp_path, contents.data(), size) != size ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+  return true;
+}
+
+// Returns true if |path| is a complete extraction of |size| bytes whose
+// SHA-256 matches the one recorded when it was extracted.
+bool IsValidExtraction(const base::FilePath& path, uint64_t size) {
+  int64_t file_size;
+  if (!base::GetFileSize(path, &file_size) ||
+      file_size != static_cast<int64_t>(size))
+    return false;
+
+  std::string expected;
+  if (!base::ReadFileToStringWithMaxSize(GetHashPath(path), &expected,
+                                         crypto::kSHA256Length * 2))
+    return false;
+
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  std::string hash;
+  return file.IsValid() && HashFileRange(&file, 0, size, &hash) &&
+         hash == expected;
+}
+
+// Records the path of the archive the entries of |key| come from.
+bool RecordArchivePath(const base::FilePath& cache_dir,
+                       const base::FilePath& archive_path,
+                       const CacheKey& key) {
+  base::FilePath path = cache_dir.AppendASCII(key.archive)
+                            .AddExtension(kArchivePathExtension);
+  if (base::PathExists(path))
+    return true;
+  return WriteCacheFile(cache_dir, path, archive_path.AsUTF8Unsafe());
+}
+
+// Deletes the entries extracted from other versions of the archive, once per
+// archive version and process. Entries still in use by another process are
+// left for a later launch.
+void EvictStaleEntries(const base::FilePath& cache_dir, const CacheKey& key) {
+  const std::string prefix = GetEntryPrefix(key);
+  {
+    EvictedArchives& evicted = g_evicted_archives.Get();
+    base::AutoLock auto_lock(evicted.lock);
+    if (!evicted.keys.insert(prefix).second)
+      return;
+  }
+
+  base::FileEnumerator enumerator(
+      cache_dir, false, base::FileEnumerator::FILES,
+      base::FilePath::FromUTF8Unsafe(key.archive + "-*").value());
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    if (!base::StartsWith(path.BaseName().AsUTF8Unsafe(), prefix,
+                          base::CompareCase::SENSITIVE))
+      base::DeleteFile(path, false);
+  }
+}
+
+}  // namespace
+
+base::FilePath GetExtractionCacheDir() {
+  base::FilePath user_data_dir;
+  if (!PathService::Get(chrome::DIR_USER_DATA, &user_data_dir))
+    return base::FilePath();
+  return user_data_dir.Append(kExtractionCacheDirName);
+}
+
+bool ExtractToCache(const base::FilePath& archive_path,
+                    base::File* archive_file,
+                    const base::FilePath::StringType& ext,
+                    uint64_t offset,
+                    uint64_t size,
+                    bool executable,
+                    base::FilePath* out) {
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  base::FilePath cache_dir = GetExtractionCacheDir();
+  if (cache_dir.empty() || !archive_file->IsValid())
+    return false;
+
+  base::File::Info archive_info;
+  if (!archive_file->GetInfo(&archive_info))
+    return false;
+
+  CacheKey key = GetCacheKey(archive_path, archive_info);
+  base::FilePath path = cache_dir.AppendASCII(
+      GetEntryPrefix(key) + base::Uint64ToString(offset) + '_' +
+      base::Uint64ToString(size)).AddExtension(ext);
+  if (IsValidExtraction(path, size)) {
+    *out = path;
+    return true;
+  }
+
+  EvictStaleEntries(cache_dir, key);
+
+  // The hash is taken from the archive, so a bad copy is caught on reuse.
+  std::string hash;
+  if (!HashFileRange(archive_file, offset, size, &hash))
+    return false;
+
+  // Write into a temporary file first so other processes never see a partial
+  // extraction.
+  base::FilePath temp_path;
+  if (!base::CreateDirectory(cache_dir) ||
+      !RecordArchivePath(cache_dir, archive_path, key) ||
+      !base::CreateTemporaryFileInDir(cache_dir, &temp_path))
+    return false;
+
+  bool copied;
+  {
+    base::File dest(temp_path,
+                    base::File::FLAG_OPEN | base::File::FLAG_WRITE);
+    copied = dest.IsValid() &&
+        CopyFileRange(archive_file, offset, size, &dest);
+  }
+
+#if defined(OS_POSIX)
+  if (copied && executable) {
+    // chmod a+x temp_path;
+    copied = base::SetPosixFilePermissions(temp_path, 0755);
+  }
+#endif
+
+  if (!copied || !WriteCacheFile(cache_dir, GetHashPath(path), hash) ||
+      !base::ReplaceFile(temp_path, path, nullptr)) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+
+  *out = path;
+  return true;
+}
+
+void SweepExtractionCache() {
+  base::ThreadRestrictions::AssertIOAllowed();
+  base::FilePath cache_dir = GetExtractionCacheDir();
+  if (cache_dir.empty() || !base::DirectoryExists(cache_dir))
+    return;
+
+  // Archives whose path is recorded and still exists.
+  std::set<std::string> live_archives;
+  base::FileEnumerator records(
+      cache_dir, false, base::FileEnumerator::FILES,
+      FILE_PATH_LITERAL("*.") + base::FilePath::StringType(
+          kArchivePathExtension));
+  for (base::FilePath path = records.Next(); !path.empty();
+       path = records.Next()) {
+    std::string archive_path;
+    if (base::ReadFileToString(path, &archive_path) &&
+        base::PathExists(base::FilePath::FromUTF8Unsafe(archive_path))) {
+      live_archives.insert(path.BaseName().RemoveExtension().AsUTF8Unsafe());
+    } else {
+      base::DeleteFile(path, false);
+    }
+  }
+
+  // Entries are named "<archive>-...", anything else is a record or a
+  // temporary file and is left alone. Entries still in use by another
+  // process are left for a later sweep.
+  base::FileEnumerator entries(cache_dir, false, base::FileEnumerator::FILES);
+  for (base::FilePath path = entries.Next(); !path.empty();
+       path = entries.Next()) {
+    std::string name = path.BaseName().AsUTF8Unsafe();
+    size_t separator = name.find('-');
+    if (separator != kNameHashSize * 2)
+      continue;
+    if (!live_archives.count(name.substr(0, separator)))
+      base::DeleteFile(path, false);
+  }
+}
+
+}  // namespace asar
@@ -0,0 +1,41 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_EXTRACTION_CACHE_H_
+#define ATOM_COMMON_ASAR_EXTRACTION_CACHE_H_
+
+#include <stdint.h>
+
+#include "base/files/file_path.h"
+
+namespace base {
+class File;
+}
+
+namespace asar {
+
+// Returns the directory that keeps files extracted from archives across
+// launches, or an empty path if the process has no user data directory.
+base::FilePath GetExtractionCacheDir();
+
+// Copies |size| bytes at |offset| of the archive at |archive_path| into the
+// extraction cache and returns the new path in |out|. The cache entry is keyed
+// by the archive's path, size and modification time plus the range, and is
+// only reused if its SHA-256 still matches the one recorded when it was
+// extracted, otherwise it is extracted again. Entries of older versions of the
+// archive are deleted when a new one is extracted.
+bool ExtractToCache(const base::FilePath& archive_path,
+                    base::File* archive_file,
+                    const base::FilePath::StringType& ext,
+                    uint64_t offset,
+                    uint64_t size,
+                    bool executable,
+                    base::FilePath* out);
+
+// Deletes the cache entries of archives that no longer exist. Blocks on IO.
+void SweepExtractionCache();
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_EXTRACTION_CACHE_H_
@@ -0,0 +1,243 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/asar/header_index.h"
+
+#include <algorithm>
+#include <queue>
+#include <utility>
+
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+
+namespace asar {
+
+namespace {
+
+// Maximum number of links followed by one lookup, guards against cycles.
+const int kMaxLinkDepth = 32;
+
+inline bool IsSeparator(char c) {
+#if defined(OS_WIN)
+  return c == '/' || c == '\\';
+#else
+  return c == '/';
+#endif
+}
+
+// Compares two paths, treating all separators as equal.
+int ComparePath(const base::StringPiece& a, const base::StringPiece& b) {
+  size_t length = std::min(a.size(), b.size());
+  for (size_t i = 0; i < length; ++i) {
+    char ca = IsSeparator(a[i]) ? '/' : a[i];
+    char cb = IsSeparator(b[i]) ? '/' : b[i];
+    if (ca != cb)
+      return static_cast<unsigned char>(ca) < static_cast<unsigned char>(cb) ?
+          -1 : 1;
+  }
+  if (a.size() == b.size())
+    return 0;
+  return a.size() < b.size() ? -1 : 1;
+}
+
+void FillEntryWithNode(HeaderIndex::Entry* entry,
+                       uint32_t header_size,
+                       const base::DictionaryValue* node) {
+  int size;
+  if (!node->GetInteger("size", &size))
+    return;
+  entry->size = static_cast<uint32_t>(size);
+
+  bool unpacked = false;
+  if (node->GetBoolean("unpacked", &unpacked) && unpacked) {
+    entry->flags |= HeaderIndex::FLAG_UNPACKED | HeaderIndex::FLAG_HAS_INFO;
+    return;
+  }
+
+  std::string offset;
+  if (!node->GetString("offset", &offset))
+    return;
+  if (!base::StringToUint64(offset, &entry->offset))
+    return;
+  entry->offset += header_size;
+
+  std::string encoding;
+  if (node->GetString("encoding", &encoding)) {
+    int compressed_size;
+    if (encoding != "gzip" || !node->GetInteger("compressedSize",
+                                                &compressed_size))
+      return;
+    entry->compressed_size = static_cast<uint32_t>(compressed_size);
+    entry->flags |= HeaderIndex::FLAG_GZIP;
+  }
+
+  bool executable = false;
+  if (node->GetBoolean("executable", &executable) && executable)
+    entry->flags |= HeaderIndex::FLAG_EXECUTABLE;
+  entry->flags |= HeaderIndex::FLAG_HAS_INFO;
+}
+
+}  // namespace
+
+HeaderIndex::HeaderIndex() {
+}
+
+HeaderIndex::~HeaderIndex() {
+}
+
+bool HeaderIndex::Build(const base::DictionaryValue& root,
+                        uint32_t header_size) {
+  entries_.clear();
+  sorted_.clear();
+  strings_.clear();
+
+  // Children are appended level by level, so the children of every directory
+  // end up next to each other.
+  std::queue<std::pair<uint32_t, const base::DictionaryValue*>> pending;
+
+  Entry root_entry = {};
+  root_entry.type = Type::DIRECTORY;
+  entries_.push_back(root_entry);
+  pending.push(std::make_pair(0u, &root));
+
+  while (!pending.empty()) {
+    uint32_t id = pending.front().first;
+    const base::DictionaryValue* node = pending.front().second;
+    pending.pop();
+
+    std::string link;
+    if (node->GetStringWithoutPathExpansion("link", &link)) {
+      entries_[id].type = Type::LINK;
+      entries_[id].first = AddString(link);
+      entries_[id].count = static_cast<uint32_t>(link.size());
+      continue;
+    }
+
+    const base::DictionaryValue* files = nullptr;
+    if (!node->GetDictionaryWithoutPathExpansion("files", &files)) {
+      entries_[id].type = Type::FILE;
+      FillEntryWithNode(&entries_[id], header_size, node);
+      continue;
+    }
+
+    entries_[id].type = Type::DIRECTORY;
+    entries_[id].first = static_cast<uint32_t>(entries_.size());
+    entries_[id].count = static_cast<uint32_t>(files->size());
+
+    std::string parent_path = Path(entries_[id]).as_string();
+    if (!parent_path.empty())
+      parent_path.push_back('/');
+
+    for (base::DictionaryValue::Iterator it(*files); !it.IsAtEnd();
+         it.Advance()) {
+      const base::DictionaryValue* child = nullptr;
+      if (!it.value().GetAsDictionary(&child))
+        return false;
+
+      Entry entry = {};
+      entry.path_offset = AddString(parent_path + it.key());
+      entry.path_length = static_cast<uint32_t>(
+          parent_path.size() + it.key().size());
+      entry.name_length = static_cast<uint32_t>(it.key().size());
+      pending.push(std::make_pair(
+          static_cast<uint32_t>(entries_.size()), child));
+      entries_.push_back(entry);
+    }
+  }
+
+  sorted_.resize(entries_.size());
+  for (uint32_t i = 0; i < sorted_.size(); ++i)
+    sorted_[i] = i;
+  std::sort(sorted_.begin(), sorted_.end(), [this](uint32_t a, uint32_t b) {
+    return ComparePath(Path(entries_[a]), Path(entries_[b])) < 0;
+  });
+
+  entries_.shrink_to_fit();
+  strings_.shrink_to_fit();
+  return true;
+}
+
+uint32_t HeaderIndex::Find(const base::StringPiece& path) const {
+  return FindThroughLinks(path, 0);
+}
+
+base::StringPiece HeaderIndex::Path(const Entry& entry) const {
+  return base::StringPiece(strings_.data() + entry.path_offset,
+                           entry.path_length);
+}
+
+base::StringPiece HeaderIndex::Name(const Entry& entry) const {
+  return base::StringPiece(
+      strings_.data() + entry.path_offset + entry.path_length -
+          entry.name_length,
+      entry.name_length);
+}
+
+base::StringPiece HeaderIndex::LinkTarget(const Entry& entry) const {
+  DCHECK(entry.type == Type::LINK);
+  return base::StringPiece(strings_.data() + entry.first, entry.count);
+}
+
+uint32_t HeaderIndex::ResolveDirectory(uint32_t id) const {
+  for (int depth = 0; id != kNotFound && depth < kMaxLinkDepth; ++depth) {
+    const Entry& entry = entries_[id];
+    if (entry.type == Type::DIRECTORY)
+      return id;
+    if (entry.type != Type::LINK)
+      return kNotFound;
+    id = FindThroughLinks(LinkTarget(entry), depth + 1);
+  }
+  return kNotFound;
+}
+
+uint32_t HeaderIndex::FindExact(const base::StringPiece& path) const {
+  auto it = std::lower_bound(
+      sorted_.begin(), sorted_.end(), path,
+      [this](uint32_t id, const base::StringPiece& path) {
+        return ComparePath(Path(entries_[id]), path) < 0;
+      });
+  if (it == sorted_.end() || ComparePath(Path(entries_[*it]), path) != 0)
+    return kNotFound;
+  return *it;
+}
+
+uint32_t HeaderIndex::FindThroughLinks(const base::StringPiece& path,
+                                       int depth) const {
+  if (depth > kMaxLinkDepth)
+    return kNotFound;
+
+  uint32_t id = FindExact(path);
+  if (id != kNotFound)
+    return id;
+
+  // The path may go through a linked directory, find the first link on the
+  // way and look up the rest of the path in its target.
+  for (size_t i = 0; i < path.size(); ++i) {
+    if (!IsSeparator(path[i]))
+      continue;
+
+    uint32_t parent = FindExact(path.substr(0, i));
+    if (parent == kNotFound)
+      return kNotFound;
+
+    const Entry& entry = entries_[parent];
+    if (entry.type == Type::FILE)
+      return kNotFound;
+    if (entry.type == Type::LINK) {
+      std::string resolved = LinkTarget(entry).as_string();
+      path.substr(i).AppendToString(&resolved);
+      return FindThroughLinks(resolved, depth + 1);
+    }
+  }
+  return kNotFound;
+}
+
+uint32_t HeaderIndex::AddString(const base::StringPiece& str) {
+  uint32_t offset = static_cast<uint32_t>(strings_.size());
+  str.AppendToString(&strings_);
+  return offset;
+}
+
+}  // namespace asar
@@ -0,0 +1,103 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_ASAR_HEADER_INDEX_H_
+#define ATOM_COMMON_ASAR_HEADER_INDEX_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace asar {
+
+// A flat, read-only index compiled from the JSON header of an asar archive.
+//
+// Every node of the header tree becomes a packed Entry. Full paths are stored
+// once in a shared string pool (names are suffixes of the paths), and a table
+// of entry ids sorted by path allows lookups in O(log n) without allocating.
+// Children of a directory are stored contiguously and in name order.
+class HeaderIndex {
+ public:
+  enum class Type : uint8_t {
+    FILE,
+    DIRECTORY,
+    LINK,
+  };
+
+  struct Entry {
+    uint64_t offset;
+    uint32_t size;
+    // Number of bytes stored in the archive for compressed files.
+    uint32_t compressed_size;
+    // Full path of the entry in |strings_|, without leading separator.
+    uint32_t path_offset;
+    uint32_t path_length;
+    // Length of the last path component.
+    uint32_t name_length;
+    // For directories, the range of children in |entries_|. For links, the
+    // target path in |strings_|.
+    uint32_t first;
+    uint32_t count;
+    Type type;
+    uint8_t flags;
+  };
+
+  enum Flags : uint8_t {
+    FLAG_UNPACKED = 1 << 0,
+    FLAG_EXECUTABLE = 1 << 1,
+    // The node has a valid size/offset.
+    FLAG_HAS_INFO = 1 << 2,
+    // The file is stored gzip compressed.
+    FLAG_GZIP = 1 << 3,
+  };
+
+  static const uint32_t kNotFound = static_cast<uint32_t>(-1);
+
+  HeaderIndex();
+  ~HeaderIndex();
+
+  // Compiles the parsed header |root|. |header_size| is added to the offset
+  // of every packed file.
+  bool Build(const base::DictionaryValue& root, uint32_t header_size);
+
+  // Returns the id of the entry at |path|, following linked directories on
+  // the way, or kNotFound.
+  uint32_t Find(const base::StringPiece& path) const;
+
+  const Entry& entry(uint32_t id) const { return entries_[id]; }
+  size_t size() const { return entries_.size(); }
+
+  base::StringPiece Path(const Entry& entry) const;
+  base::StringPiece Name(const Entry& entry) const;
+  base::StringPiece LinkTarget(const Entry& entry) const;
+
+  // Returns the entry that holds the children of |id|, resolving links, or
+  // kNotFound if it is not a directory.
+  uint32_t ResolveDirectory(uint32_t id) const;
+
+ private:
+  uint32_t FindExact(const base::StringPiece& path) const;
+  uint32_t FindThroughLinks(const base::StringPiece& path, int depth) const;
+
+  uint32_t AddString(const base::StringPiece& str);
+
+  std::vector<Entry> entries_;
+  // Entry ids sorted by path.
+  std::vector<uint32_t> sorted_;
+  std::string strings_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeaderIndex);
+};
+
+}  // namespace asar
+
+#endif  // ATOM_COMMON_ASAR_HEADER_INDEX_H_
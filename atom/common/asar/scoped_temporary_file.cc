@@ -4,8 +4,7 @@
 
 #include "atom/common/asar/scoped_temporary_file.h"
 
-#include <vector>
-
+#include "atom/common/asar/asar_util.h"
 #include "base/files/file_util.h"
 #include "base/threading/thread_restrictions.h"
 
@@ -58,17 +57,22 @@ bool ScopedTemporaryFile::InitFromFile(base::File* src,
   if (!Init(ext))
     return false;
 
-  std::vector<char> buf(size);
-  int len = src->Read(offset, buf.data(), buf.size());
-  if (len != static_cast<int>(size))
-    return false;
-
   base::File dest(path_, base::File::FLAG_OPEN | base::File::FLAG_WRITE);
   if (!dest.IsValid())
     return false;
 
-  return dest.WriteAtCurrentPos(buf.data(), buf.size()) ==
-      static_cast<int>(size);
+  return CopyFileRange(src, offset, size, &dest);
+}
+
+bool ScopedTemporaryFile::InitFromContents(
+    const base::FilePath::StringType& ext,
+    const base::StringPiece& contents) {
+  if (!Init(ext))
+    return false;
+
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  return base::WriteFile(path_, contents.data(), contents.size()) ==
+      static_cast<int>(contents.size());
 }
 
 }  // namespace asar
@@ -4,6 +4,7 @@
 
 #include "atom/common/javascript_bindings.h"
 
+#include <utility>
 #include <vector>
 #include "atom/common/api/api_messages.h"
 #include "atom/common/api/atom_api_key_weak_map.h"
@@ -11,6 +12,7 @@
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "atom/renderer/shared_ring_sender.h"
 #include "base/memory/shared_memory.h"
 #include "base/memory/shared_memory_handle.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
@@ -160,6 +162,27 @@ void JavascriptBindings::IPCSendShared(mate::Arguments* args,
     args->ThrowError("Unable to send AtomViewHostMsg_Message_Shared");
 }
 
+bool JavascriptBindings::IPCSendRing(mate::Arguments* args,
+                                     v8::Local<v8::Value> message) {
+  if (!is_valid() || !render_frame())
+    return false;
+
+  v8::Isolate* isolate = args->isolate();
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(context()->v8_context(), message)
+          .FromMaybe(false)) {
+    // error will be thrown by serializer
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buf = serializer.Release();
+  bool success = SharedRingSender::FromRenderFrame(render_frame())->Send(
+      buf.first, buf.second);
+  free(buf.first);
+  return success;
+}
+
 base::string16 JavascriptBindings::IPCSendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments) {
@@ -179,6 +202,33 @@ base::string16 JavascriptBindings::IPCSendSync(mate::Arguments* args,
   return json;
 }
 
+v8::Local<v8::Value> JavascriptBindings::IPCSendSyncSerialized(
+    mate::Arguments* args,
+    const base::string16& channel,
+    const base::ListValue& arguments) {
+  v8::Isolate* isolate = args->isolate();
+  if (!is_valid() || !render_frame())
+    return v8::Null(isolate);
+
+  std::vector<uint8_t> result;
+  IPC::SyncMessage* message = new AtomViewHostMsg_Message_Sync_Serialized(
+      routing_id(), channel, arguments, &result);
+  if (!Send(message)) {
+    args->ThrowError("Unable to send AtomViewHostMsg_Message_Sync_Serialized");
+    return v8::Null(isolate);
+  }
+
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::ValueDeserializer deserializer(isolate, result.data(), result.size());
+  v8::Local<v8::Value> value;
+  if (!deserializer.ReadHeader(v8_context).FromMaybe(false) ||
+      !deserializer.ReadValue(v8_context).ToLocal(&value)) {
+    // error will be thrown by deserializer
+    return v8::Null(isolate);
+  }
+  return value;
+}
+
 void JavascriptBindings::GetBinding(
       const v8::FunctionCallbackInfo<v8::Value>& args) {
   blink::WebLocalFrame* frame = context()->web_frame();
@@ -192,8 +242,13 @@ void JavascriptBindings::GetBinding(
       base::Unretained(this)));
   ipc.SetMethod("sendSync", base::Bind(&JavascriptBindings::IPCSendSync,
       base::Unretained(this)));
+  ipc.SetMethod("sendSyncSerialized",
+      base::Bind(&JavascriptBindings::IPCSendSyncSerialized,
+      base::Unretained(this)));
   ipc.SetMethod("sendShared", base::Bind(&JavascriptBindings::IPCSendShared,
       base::Unretained(this)));
+  ipc.SetMethod("sendRing", base::Bind(&JavascriptBindings::IPCSendRing,
+      base::Unretained(this)));
   binding.Set("ipc", ipc.GetHandle());
 
   mate::Dictionary v8(isolate, v8::Object::New(isolate));
@@ -34,9 +34,13 @@ class JavascriptBindings : public content::RenderFrameObserver,
   void IPCSendShared(mate::Arguments* args,
             const base::string16& channel,
             base::SharedMemory* shared_memory);
+  bool IPCSendRing(mate::Arguments* args, v8::Local<v8::Value> message);
   base::string16 IPCSendSync(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
+  v8::Local<v8::Value> IPCSendSyncSerialized(mate::Arguments* args,
+      const base::string16& channel,
+      const base::ListValue& arguments);
   void IPCSend(mate::Arguments* args,
                         const base::string16& channel,
                         const base::ListValue& arguments);
@@ -66,6 +66,8 @@ struct Converter<net::X509Certificate> {
 
 namespace atom {
 
+// Fills |details| with the method, url, referrer and upload data of |request|,
+// which is all that login and protocol handlers are given.
 void FillRequestDetails(base::DictionaryValue* details,
                         const net::URLRequest* request);
 
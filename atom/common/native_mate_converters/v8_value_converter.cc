@@ -130,7 +130,8 @@ class V8ValueConverter::ScopedUniquenessGuard {
 V8ValueConverter::V8ValueConverter()
     : reg_exp_allowed_(false),
       function_allowed_(false),
-      strip_null_from_objects_(false) {}
+      strip_null_from_objects_(false),
+      buffer_allowed_(true) {}
 
 void V8ValueConverter::SetRegExpAllowed(bool val) {
   reg_exp_allowed_ = val;
@@ -144,6 +145,10 @@ void V8ValueConverter::SetStripNullFromObjects(bool val) {
   strip_null_from_objects_ = val;
 }
 
+void V8ValueConverter::SetBufferAllowed(bool val) {
+  buffer_allowed_ = val;
+}
+
 v8::Local<v8::Value> V8ValueConverter::ToV8Value(
     const base::Value* value, v8::Local<v8::Context> context) const {
   v8::Context::Scope context_scope(context);
@@ -320,6 +325,8 @@ base::Value* V8ValueConverter::FromV8ValueImpl(
   }
 
   if (node::Buffer::HasInstance(val)) {
+    if (!buffer_allowed_)
+      return nullptr;
     return FromNodeBuffer(val, state, isolate);
   }
 
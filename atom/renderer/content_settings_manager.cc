@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include "atom/common/api/api_messages.h"
+#include "atom/renderer/content_settings_matcher.h"
 #include "base/values.h"
 #include "components/content_settings/core/common/content_settings_pattern.h"
 #include "content/public/common/url_constants.h"
@@ -18,7 +19,8 @@
 
 namespace atom {
 
-ContentSettingsManager::ContentSettingsManager() {
+ContentSettingsManager::ContentSettingsManager()
+    : content_settings_version_(0) {
   content::RenderThread::Get()->AddObserver(this);
 }
 
@@ -52,6 +54,8 @@ bool ContentSettingsManager::OnControlMessageReceived(
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(ContentSettingsManager, message)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettings, OnUpdateContentSettings)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettingsDelta,
+                        OnUpdateContentSettingsDelta)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateWebKitPrefs, OnUpdateWebKitPrefs)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
@@ -64,14 +68,38 @@ void ContentSettingsManager::OnUpdateWebKitPrefs(
 }
 
 void ContentSettingsManager::OnUpdateContentSettings(
-    const base::DictionaryValue& content_settings) {
+    const base::DictionaryValue& content_settings,
+    int version) {
   content_settings_ = content_settings.CreateDeepCopy();
+  content_settings_version_ = version;
+  matcher_.reset(new ContentSettingsMatcher(content_settings));
+}
+
+void ContentSettingsManager::OnUpdateContentSettingsDelta(
+    int base_version,
+    int version,
+    const base::DictionaryValue& changes) {
+  // The browser sends everything to processes that aren't at |base_version|.
+  DCHECK_EQ(content_settings_version_, base_version);
+  if (!content_settings_ || !matcher_)
+    return;
+
+  for (base::DictionaryValue::Iterator it(changes); !it.IsAtEnd();
+       it.Advance()) {
+    if (it.value().IsType(base::Value::Type::NONE))
+      content_settings_->RemoveWithoutPathExpansion(it.key(), nullptr);
+    else
+      content_settings_->SetWithoutPathExpansion(it.key(),
+                                                 it.value().CreateDeepCopy());
+    matcher_->UpdateContentType(it.key(), it.value());
+  }
+  content_settings_version_ = version;
 }
 
 ContentSetting ContentSettingsManager::GetSetting(
-    GURL primary_url,
-    GURL secondary_url,
-    std::string content_type,
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    const std::string& content_type,
     bool incognito) {
   bool default_value = true;
   if (content_type == "cookies")
@@ -83,10 +111,13 @@ ContentSetting ContentSettingsManager::GetSetting(
   else if (content_type == "runInsecureContent")
     default_value = web_preferences_.allow_running_insecure_content;
 
-  return GetContentSettingFromRules(primary_url,
-                                    secondary_url,
-                                    content_type,
-                                    default_value);
+  ContentSetting default_setting = default_value
+    ? ContentSetting::CONTENT_SETTING_ALLOW
+    : ContentSetting::CONTENT_SETTING_BLOCK;
+  if (!matcher_)
+    return default_setting;
+  return matcher_->GetSetting(primary_url, secondary_url, content_type,
+                              default_setting);
 }
 
 std::vector<std::string> ContentSettingsManager::GetContentTypes() {
@@ -101,56 +132,4 @@ std::vector<std::string> ContentSettingsManager::GetContentTypes() {
   return content_types;
 }
 
-ContentSetting ContentSettingsManager::GetContentSettingFromRules(
-    const GURL& primary_url,
-    const GURL& secondary_url,
-    const std::string& content_type,
-    const bool& default_value) {
-  ContentSetting result = default_value
-    ? ContentSetting::CONTENT_SETTING_ALLOW
-    : ContentSetting::CONTENT_SETTING_BLOCK;
-
-  base::ListValue* rules = nullptr;
-  if (!content_settings_->GetList(content_type, &rules))
-    return result;
-
-  // all rules are evaluated in order and the
-  // most specific matching rule will apply
-  for (base::ListValue::iterator it = rules->begin();
-       it != rules->end(); ++it) {
-    base::DictionaryValue* rule;
-    std::string pattern_string;
-    std::string setting_string;
-    if (!it->GetAsDictionary(&rule) ||
-        !rule->GetString("primaryPattern", &pattern_string) ||
-        !rule->GetString("setting", &setting_string)) {
-      // skip invalid entries
-      // TODO(bridiver) should also send an ipc error message
-      ++it;
-    } else {
-      std::string secondary_pattern_string;
-      rule->GetString("secondaryPattern", &secondary_pattern_string);
-
-      ContentSetting setting = result;
-      if (setting_string != "block" && setting_string != "deny") {
-        setting = ContentSetting::CONTENT_SETTING_ALLOW;
-      } else {
-        setting = ContentSetting::CONTENT_SETTING_BLOCK;
-      }
-
-      if (secondary_pattern_string == "[firstParty]") {
-        secondary_pattern_string = "[*.]" + primary_url.HostNoBrackets();
-      }
-
-      if (ContentSettingsPattern::FromString(
-            pattern_string).Matches(primary_url) &&
-          // if there is a secondary resource pattern it has to match as well
-          (secondary_pattern_string.empty() ||
-            ContentSettingsPattern::FromString(
-              secondary_pattern_string).Matches(secondary_url)))
-        result = setting;
-    }
-  }
-  return result;
-}
 }  // namespace atom
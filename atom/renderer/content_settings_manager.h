@@ -27,6 +27,8 @@ class WebFrame;
 
 namespace atom {
 
+class ContentSettingsMatcher;
+
 class ContentSettingsManager : public content::RenderThreadObserver {
  public:
   ContentSettingsManager();
@@ -39,31 +41,33 @@ class ContentSettingsManager : public content::RenderThreadObserver {
     { return content_settings_.get(); };
 
   ContentSetting GetSetting(
-      GURL primary_url,
-      GURL secondary_url,
-      std::string resource_id,
+      const GURL& primary_url,
+      const GURL& secondary_url,
+      const std::string& content_type,
       bool incognito);
 
   std::vector<std::string> GetContentTypes();
 
  private:
-  ContentSetting GetContentSettingFromRules(
-    const GURL& primary_url,
-    const GURL& secondary_url,
-    const std::string& content_type,
-    const bool& enabled_per_settings);
-
   // content::RenderThreadObserver:
   bool OnControlMessageReceived(const IPC::Message& message) override;
 
   void OnUpdateWebKitPrefs(
       const content::WebPreferences& web_preferences);
   void OnUpdateContentSettings(
-      const base::DictionaryValue& content_settings);
-
+      const base::DictionaryValue& content_settings,
+      int version);
+  void OnUpdateContentSettingsDelta(
+      int base_version,
+      int version,
+      const base::DictionaryValue& changes);
 
   content::WebPreferences web_preferences_;
   std::unique_ptr<base::DictionaryValue> content_settings_;
+  // Version of |content_settings_| in the browser.
+  int content_settings_version_;
+  // |content_settings_| compiled for queries.
+  std::unique_ptr<ContentSettingsMatcher> matcher_;
 
   DISALLOW_COPY_AND_ASSIGN(ContentSettingsManager);
 };
@@ -0,0 +1,184 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/content_settings_matcher.h"
+
+#include "base/values.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+const char kFirstPartyPattern[] = "[firstParty]";
+
+base::StringPiece TrimEndingDot(base::StringPiece host) {
+  if (!host.empty() && host.back() == '.')
+    host.remove_suffix(1);
+  return host;
+}
+
+// Same as matching |secondary_url| against "[*.]" + the primary host, without
+// building the pattern.
+bool MatchesFirstParty(const GURL& primary_url, const GURL& secondary_url) {
+  base::StringPiece primary = TrimEndingDot(primary_url.host_piece());
+  base::StringPiece secondary = TrimEndingDot(secondary_url.host_piece());
+  if (primary.empty() || !secondary_url.is_valid())
+    return false;
+  if (secondary == primary)
+    return true;
+  return secondary.size() > primary.size() &&
+      secondary.ends_with(primary) &&
+      secondary[secondary.size() - primary.size() - 1] == '.';
+}
+
+}  // namespace
+
+ContentSettingsMatcher::Rule::Rule()
+    : first_party_secondary(false),
+      setting(CONTENT_SETTING_DEFAULT) {
+}
+
+ContentSettingsMatcher::Rule::Rule(const Rule& other) = default;
+
+ContentSettingsMatcher::Rule::~Rule() {
+}
+
+ContentSettingsMatcher::RuleSet::RuleSet() {
+}
+
+ContentSettingsMatcher::RuleSet::~RuleSet() {
+}
+
+ContentSettingsMatcher::ContentSettingsMatcher(
+    const base::DictionaryValue& settings) {
+  for (base::DictionaryValue::Iterator it(settings); !it.IsAtEnd();
+       it.Advance()) {
+    const base::ListValue* list;
+    if (it.value().GetAsList(&list))
+      BuildRuleSet(*list, &rule_sets_[it.key()]);
+  }
+}
+
+ContentSettingsMatcher::~ContentSettingsMatcher() {
+}
+
+ContentSetting ContentSettingsMatcher::GetSetting(
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    const std::string& content_type,
+    ContentSetting default_setting) const {
+  auto it = rule_sets_.find(content_type);
+  if (it == rule_sets_.end())
+    return default_setting;
+  const RuleSet& rule_set = it->second;
+
+  int best = -1;
+  FindInBucket(rule_set, rule_set.any_host, primary_url, secondary_url, &best);
+
+  base::StringPiece host = TrimEndingDot(primary_url.host_piece());
+  auto exact = rule_set.exact_hosts.find(host);
+  if (exact != rule_set.exact_hosts.end())
+    FindInBucket(rule_set, exact->second, primary_url, secondary_url, &best);
+
+  // Try the host and each of its parent domains.
+  while (!host.empty()) {
+    auto subdomain = rule_set.subdomain_hosts.find(host);
+    if (subdomain != rule_set.subdomain_hosts.end())
+      FindInBucket(rule_set, subdomain->second, primary_url, secondary_url,
+                   &best);
+    size_t dot = host.find('.');
+    if (dot == base::StringPiece::npos)
+      break;
+    host.remove_prefix(dot + 1);
+  }
+
+  return best < 0 ? default_setting : rule_set.rules[best].setting;
+}
+
+void ContentSettingsMatcher::UpdateContentType(
+    const std::string& content_type,
+    const base::Value& rules) {
+  rule_sets_.erase(content_type);
+  const base::ListValue* list;
+  if (rules.GetAsList(&list))
+    BuildRuleSet(*list, &rule_sets_[content_type]);
+}
+
+// static
+void ContentSettingsMatcher::BuildRuleSet(const base::ListValue& list,
+                                          RuleSet* rule_set) {
+  for (const auto& value : list) {
+    const base::DictionaryValue* dict;
+    std::string primary_string;
+    std::string setting_string;
+    if (!value.GetAsDictionary(&dict) ||
+        !dict->GetString("primaryPattern", &primary_string) ||
+        !dict->GetString("setting", &setting_string)) {
+      // skip invalid entries
+      // TODO(bridiver) should also send an ipc error message
+      continue;
+    }
+
+    Rule rule;
+    rule.primary_pattern = ContentSettingsPattern::FromString(primary_string);
+    // Invalid patterns never match.
+    if (!rule.primary_pattern.IsValid())
+      continue;
+
+    std::string secondary_string;
+    dict->GetString("secondaryPattern", &secondary_string);
+    if (secondary_string == kFirstPartyPattern) {
+      rule.first_party_secondary = true;
+    } else if (!secondary_string.empty()) {
+      rule.secondary_pattern =
+          ContentSettingsPattern::FromString(secondary_string);
+      if (!rule.secondary_pattern.IsValid())
+        continue;
+    }
+
+    rule.setting = setting_string != "block" && setting_string != "deny" ?
+        CONTENT_SETTING_ALLOW : CONTENT_SETTING_BLOCK;
+    rule_set->rules.push_back(rule);
+    rule_set->hosts.push_back(rule.primary_pattern.GetHost());
+  }
+
+  for (size_t i = 0; i < rule_set->rules.size(); ++i) {
+    const Rule& rule = rule_set->rules[i];
+    base::StringPiece host = rule_set->hosts[i];
+    if (host.empty())
+      rule_set->any_host.push_back(i);
+    else if (rule.primary_pattern.HasDomainWildcard())
+      rule_set->subdomain_hosts[host].push_back(i);
+    else
+      rule_set->exact_hosts[host].push_back(i);
+  }
+}
+
+// static
+void ContentSettingsMatcher::FindInBucket(const RuleSet& rule_set,
+                                          const Bucket& bucket,
+                                          const GURL& primary_url,
+                                          const GURL& secondary_url,
+                                          int* best) {
+  for (auto it = bucket.rbegin(); it != bucket.rend(); ++it) {
+    if (static_cast<int>(*it) <= *best)
+      return;
+    const Rule& rule = rule_set.rules[*it];
+    if (!rule.primary_pattern.Matches(primary_url))
+      continue;
+    // if there is a secondary resource pattern it has to match as well
+    if (rule.first_party_secondary) {
+      if (!MatchesFirstParty(primary_url, secondary_url))
+        continue;
+    } else if (rule.secondary_pattern.IsValid() &&
+               !rule.secondary_pattern.Matches(secondary_url)) {
+      continue;
+    }
+    *best = static_cast<int>(*it);
+    return;
+  }
+}
+
+}  // namespace atom
@@ -0,0 +1,99 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_CONTENT_SETTINGS_MATCHER_H_
+#define ATOM_RENDERER_CONTENT_SETTINGS_MATCHER_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
+
+class GURL;
+
+namespace base {
+class DictionaryValue;
+class ListValue;
+class Value;
+}
+
+namespace atom {
+
+// Content settings rules sent by the browser, compiled once per update.
+//
+// The rules of each content type are parsed into ContentSettingsPatterns and
+// bucketed by the host of their primary pattern, like URLPatternIndex does
+// for webRequest filters. Rules are evaluated in order and the last matching
+// one wins, so a query looks for the matching rule with the highest index
+// among the buckets that can apply to the primary URL.
+class ContentSettingsMatcher {
+ public:
+  explicit ContentSettingsMatcher(const base::DictionaryValue& settings);
+  ~ContentSettingsMatcher();
+
+  // Returns the setting of the last rule for |content_type| matching the
+  // URLs, or |default_setting| if none does.
+  ContentSetting GetSetting(const GURL& primary_url,
+                            const GURL& secondary_url,
+                            const std::string& content_type,
+                            ContentSetting default_setting) const;
+
+  // Recompiles the rules of |content_type| from |rules|, the content type is
+  // removed when |rules| is not a list.
+  void UpdateContentType(const std::string& content_type,
+                         const base::Value& rules);
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(const Rule& other);
+    ~Rule();
+
+    ContentSettingsPattern primary_pattern;
+    ContentSettingsPattern secondary_pattern;
+    // "[firstParty]" matches the primary URL's host and its subdomains.
+    bool first_party_secondary;
+    ContentSetting setting;
+  };
+
+  // Rule indices in ascending order.
+  using Bucket = std::vector<size_t>;
+  using HostMap =
+      std::unordered_map<base::StringPiece, Bucket, base::StringPieceHash>;
+
+  struct RuleSet {
+    RuleSet();
+    ~RuleSet();
+
+    std::vector<Rule> rules;
+    // The primary pattern's host of every rule, the host maps point into it.
+    std::vector<std::string> hosts;
+    Bucket any_host;
+    HostMap exact_hosts;
+    HostMap subdomain_hosts;
+  };
+
+  static void BuildRuleSet(const base::ListValue& list, RuleSet* rule_set);
+
+  // Updates |best| with the highest index in |bucket| above it whose rule
+  // matches.
+  static void FindInBucket(const RuleSet& rule_set,
+                           const Bucket& bucket,
+                           const GURL& primary_url,
+                           const GURL& secondary_url,
+                           int* best);
+
+  std::map<std::string, RuleSet> rule_sets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsMatcher);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_CONTENT_SETTINGS_MATCHER_H_
@@ -0,0 +1,71 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/shared_ring_sender.h"
+
+#include <utility>
+
+#include "atom/common/api/api_messages.h"
+#include "atom/common/api/shared_ring_buffer.h"
+#include "base/memory/shared_memory.h"
+#include "content/public/renderer/render_frame.h"
+#include "content/public/renderer/render_thread.h"
+
+namespace atom {
+
+namespace {
+
+const uint32_t kRingBufferCapacity = 1 << 20;
+
+}  // namespace
+
+// static
+SharedRingSender* SharedRingSender::FromRenderFrame(
+    content::RenderFrame* render_frame) {
+  SharedRingSender* sender = Get(render_frame);
+  if (!sender)
+    sender = new SharedRingSender(render_frame);
+  return sender;
+}
+
+SharedRingSender::SharedRingSender(content::RenderFrame* render_frame)
+    : content::RenderFrameObserver(render_frame),
+      content::RenderFrameObserverTracker<SharedRingSender>(render_frame) {
+}
+
+SharedRingSender::~SharedRingSender() {
+}
+
+bool SharedRingSender::Send(const uint8_t* data, size_t size) {
+  if (!buffer_) {
+    buffer_ = SharedRingBuffer::CreateProducer(
+        content::RenderThread::Get()->HostAllocateSharedMemoryBuffer(
+            SharedRingBuffer::GetMemorySize(kRingBufferCapacity)),
+        kRingBufferCapacity);
+    if (!buffer_)
+      return false;
+
+    base::SharedMemoryHandle handle = buffer_->ShareHandle();
+    if (!handle.IsValid() ||
+        !RenderFrameObserver::Send(new AtomViewHostMsg_OpenRingBuffer(
+            routing_id(), handle, kRingBufferCapacity))) {
+      buffer_.reset();
+      return false;
+    }
+  }
+
+  bool needs_signal = false;
+  if (!buffer_->Write(data, size, &needs_signal))
+    return false;
+  if (needs_signal)
+    RenderFrameObserver::Send(new AtomViewHostMsg_RingBufferSignal(
+        routing_id()));
+  return true;
+}
+
+void SharedRingSender::OnDestruct() {
+  delete this;
+}
+
+}  // namespace atom
@@ -0,0 +1,46 @@
+// Copyright (c) 2017 GitHub, Inc.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_SHARED_RING_SENDER_H_
+#define ATOM_RENDERER_SHARED_RING_SENDER_H_
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "base/macros.h"
+#include "content/public/renderer/render_frame_observer.h"
+#include "content/public/renderer/render_frame_observer_tracker.h"
+
+namespace atom {
+
+class SharedRingBuffer;
+
+// Sends messages of a frame to the browser through a SharedRingBuffer, which
+// is created on the first message and shared with the browser once.
+class SharedRingSender
+    : public content::RenderFrameObserver,
+      public content::RenderFrameObserverTracker<SharedRingSender> {
+ public:
+  static SharedRingSender* FromRenderFrame(content::RenderFrame* render_frame);
+
+  // Appends a serialized message, returns false if it doesn't fit in the
+  // buffer right now.
+  bool Send(const uint8_t* data, size_t size);
+
+ private:
+  explicit SharedRingSender(content::RenderFrame* render_frame);
+  ~SharedRingSender() override;
+
+  // content::RenderFrameObserver:
+  void OnDestruct() override;
+
+  std::unique_ptr<SharedRingBuffer> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedRingSender);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_SHARED_RING_SENDER_H_
@@ -4,14 +4,30 @@
 
 #include "brave/browser/resource_coordinator/guest_tab_manager.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #include "atom/browser/extensions/tab_helper.h"
+#include "base/bind.h"
+#include "base/process/process_metrics.h"
+#include "base/task_scheduler/post_task.h"
 #include "brave/browser/guest_view/tab_view/tab_view_guest.h"
 #include "chrome/browser/profiles/profile.h"
+#include "chrome/browser/ui/browser.h"
+#include "chrome/browser/ui/browser_list.h"
 #include "chrome/browser/ui/tabs/tab_strip_model.h"
 #include "content/browser/frame_host/navigation_controller_impl.h"
 #include "content/browser/web_contents/web_contents_impl.h"
 #include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_frame_host.h"
+#include "content/public/browser/render_process_host.h"
+
+#if defined(OS_MACOSX)
+#include "content/public/browser/browser_child_process_host.h"
+#endif
 
+using base::MemoryPressureListener;
 using content::BrowserThread;
 using content::WebContents;
 
@@ -35,7 +51,218 @@ DEFINE_WEB_CONTENTS_USER_DATA_KEY(content::RestoreHelper);
 
 namespace resource_coordinator {
 
-GuestTabManager::GuestTabManager() : TabManager() {}
+namespace {
+
+const double kBytesPerMegabyte = 1024 * 1024;
+
+// Renderer id => process.
+using ProcessHandleMap = std::map<int, base::ProcessHandle>;
+
+std::unique_ptr<std::map<int, uint64_t>> MeasureProcessMemory(
+    const ProcessHandleMap& processes) {
+  std::unique_ptr<std::map<int, uint64_t>> memory(
+      new std::map<int, uint64_t>);
+  for (const auto& process : processes) {
+#if defined(OS_MACOSX)
+    std::unique_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(
+            process.second,
+            content::BrowserChildProcessHost::GetPortProvider()));
+#else
+    std::unique_ptr<base::ProcessMetrics> metrics(
+        base::ProcessMetrics::CreateProcessMetrics(process.second));
+#endif
+    size_t private_bytes, shared_bytes;
+    if (metrics->GetMemoryBytes(&private_bytes, &shared_bytes))
+      (*memory)[process.first] = private_bytes;
+  }
+  return memory;
+}
+
+int GetProcessId(WebContents* contents) {
+  return contents->GetMainFrame()->GetProcess()->GetID();
+}
+
+struct DiscardCandidate {
+  WebContents* contents;
+  uint64_t bytes;
+  double score;
+};
+
+}  // namespace
+
+class GuestTabManager::RestoreObserver : public content::WebContentsObserver {
+ public:
+  RestoreObserver(GuestTabManager* manager, WebContents* contents)
+      : content::WebContentsObserver(contents),
+        manager_(manager),
+        start_(base::TimeTicks::Now()) {}
+
+  // content::WebContentsObserver:
+  void DidStopLoading() override {
+    // Deletes this.
+    manager_->OnTabRestored(web_contents(), base::TimeTicks::Now() - start_);
+  }
+  void WebContentsDestroyed() override {
+    // Deletes this.
+    manager_->restoring_tabs_.erase(web_contents());
+  }
+
+ private:
+  GuestTabManager* manager_;
+  base::TimeTicks start_;
+
+  DISALLOW_COPY_AND_ASSIGN(RestoreObserver);
+};
+
+GuestTabManager::DiscardStats::DiscardStats()
+    : memory_budget(0),
+      tab_memory(0),
+      discards(0),
+      reclaimed_bytes(0),
+      restores(0) {
+}
+
+GuestTabManager::GuestTabManager()
+    : TabManager(),
+      measuring_(false),
+      memory_budget_(0),
+      tab_memory_(0),
+      discards_(0),
+      reclaimed_bytes_(0),
+      restores_(0),
+      weak_factory_(this) {
+  discard_pressure_listener_.reset(new MemoryPressureListener(
+      base::Bind(&GuestTabManager::OnMemoryPressure,
+                 weak_factory_.GetWeakPtr())));
+}
+
+GuestTabManager::~GuestTabManager() {
+}
+
+void GuestTabManager::SetMemoryBudget(uint64_t bytes) {
+  memory_budget_ = bytes;
+}
+
+GuestTabManager::DiscardStats GuestTabManager::GetDiscardStats() const {
+  DiscardStats stats;
+  stats.memory_budget = memory_budget_;
+  stats.tab_memory = tab_memory_;
+  stats.discards = discards_;
+  stats.reclaimed_bytes = reclaimed_bytes_;
+  stats.restores = restores_;
+  if (restores_)
+    stats.average_restore_time = total_restore_time_ / restores_;
+  stats.max_restore_time = max_restore_time_;
+  return stats;
+}
+
+void GuestTabManager::OnTabRestoreStarted(WebContents* contents) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  restoring_tabs_[contents].reset(new RestoreObserver(this, contents));
+}
+
+void GuestTabManager::OnTabRestored(WebContents* contents,
+                                    base::TimeDelta time) {
+  ++restores_;
+  total_restore_time_ += time;
+  max_restore_time_ = std::max(max_restore_time_, time);
+  restoring_tabs_.erase(contents);
+}
+
+void GuestTabManager::OnMemoryPressure(
+    MemoryPressureListener::MemoryPressureLevel level) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (level == MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE ||
+      measuring_)
+    return;
+  // Only critical pressure discards tabs without a budget.
+  if (!memory_budget_ &&
+      level != MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL)
+    return;
+
+  ProcessHandleMap processes;
+  for (auto* browser : *BrowserList::GetInstance()) {
+    TabStripModel* model = browser->tab_strip_model();
+    for (int i = 0; i < model->count(); ++i) {
+      content::RenderProcessHost* host =
+          model->GetWebContentsAt(i)->GetMainFrame()->GetProcess();
+      if (host->GetHandle() != base::kNullProcessHandle)
+        processes[host->GetID()] = host->GetHandle();
+    }
+  }
+
+  // Reading the memory of hundreds of processes can be slow.
+  measuring_ = true;
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::Bind(&MeasureProcessMemory, processes),
+      base::Bind(&GuestTabManager::OnMemoryMeasured,
+                 weak_factory_.GetWeakPtr(), level));
+}
+
+void GuestTabManager::OnMemoryMeasured(
+    MemoryPressureListener::MemoryPressureLevel level,
+    std::unique_ptr<ProcessMemoryMap> memory) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  measuring_ = false;
+
+  // A renderer is only freed when all of its tabs are discarded, so each tab
+  // is accounted for its share of the renderer.
+  std::map<int, int> tab_counts;
+  std::vector<WebContents*> background_tabs;
+  for (auto* browser : *BrowserList::GetInstance()) {
+    TabStripModel* model = browser->tab_strip_model();
+    for (int i = 0; i < model->count(); ++i) {
+      WebContents* contents = model->GetWebContentsAt(i);
+      ++tab_counts[GetProcessId(contents)];
+      if (i != model->active_index())
+        background_tabs.push_back(contents);
+    }
+  }
+
+  tab_memory_ = 0;
+  for (const auto& process : tab_counts) {
+    auto it = memory->find(process.first);
+    if (it != memory->end())
+      tab_memory_ += it->second;
+  }
+
+  base::TimeTicks now = base::TimeTicks::Now();
+  std::vector<DiscardCandidate> candidates;
+  for (WebContents* contents : background_tabs) {
+    auto tab_helper = extensions::TabHelper::FromWebContents(contents);
+    if (!tab_helper || tab_helper->is_pinned() ||
+        tab_helper->is_placeholder() || tab_helper->IsDiscarded() ||
+        !IsTabAutoDiscardable(contents) || contents->WasRecentlyAudible())
+      continue;
+
+    int process_id = GetProcessId(contents);
+    auto it = memory->find(process_id);
+    uint64_t bytes =
+        it == memory->end() ? 0 : it->second / tab_counts[process_id];
+    double idle_time = (now - contents->GetLastActiveTime()).InSecondsF();
+    candidates.push_back(
+        {contents, bytes, idle_time * (1 + bytes / kBytesPerMegabyte)});
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const DiscardCandidate& a, const DiscardCandidate& b) {
+              return a.score > b.score;
+            });
+
+  uint64_t remaining = tab_memory_;
+  int discards = 0;
+  for (const auto& candidate : candidates) {
+    if (memory_budget_ ? remaining <= memory_budget_ : discards > 0)
+      break;
+    if (!extensions::TabHelper::FromWebContents(candidate.contents)->Discard())
+      continue;
+    ++discards;
+    remaining -= std::min(remaining, candidate.bytes);
+    reclaimed_bytes_ += candidate.bytes;
+  }
+  discards_ += discards;
+}
 
 WebContents* GuestTabManager::CreateNullContents(
     TabStripModel* model, WebContents* old_contents) {
@@ -92,6 +319,7 @@ void GuestTabManager::ActiveTabChanged(content::WebContents* old_contents,
     auto tab_helper = extensions::TabHelper::FromWebContents(new_contents);
     if (!tab_helper->is_placeholder()) {
       // if the helper is set this is a discarded tab so we need to reload
+      OnTabRestoreStarted(new_contents);
       new_contents->GetController().Reload(content::ReloadType::NORMAL, true);
     }
   }
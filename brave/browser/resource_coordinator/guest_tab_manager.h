@@ -5,6 +5,14 @@
 #ifndef BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_MANAGER_H_
 #define BRAVE_BROWSER_RESOURCE_COORDINATOR_GUEST_TAB_MANAGER_H_
 
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "chrome/browser/resource_coordinator/tab_manager.h"
 
 #include "content/public/browser/web_contents_observer.h"
@@ -28,11 +36,46 @@ class RestoreHelper : public WebContentsObserver,
 
 namespace resource_coordinator {
 
+// Discards background tab guests when the system is under memory pressure.
+//
+// Tabs that are active, pinned, audible or not auto discardable are never
+// discarded. The others are discarded in order of their idle time weighted
+// by the private memory of their renderer, until the renderers of all the
+// tabs fit the memory budget. Without a budget a single tab is discarded on
+// critical memory pressure.
 class GuestTabManager : public TabManager {
  public:
+  struct DiscardStats {
+    DiscardStats();
+
+    uint64_t memory_budget;
+    // Private memory of the tab renderers at the last memory pressure signal.
+    uint64_t tab_memory;
+    int discards;
+    // Estimated from the memory of the discarded tabs' renderers.
+    uint64_t reclaimed_bytes;
+    int restores;
+    base::TimeDelta average_restore_time;
+    base::TimeDelta max_restore_time;
+  };
+
   GuestTabManager();
+  ~GuestTabManager() override;
+
+  // 0 disables the budget.
+  void SetMemoryBudget(uint64_t bytes);
+  DiscardStats GetDiscardStats() const;
+
+  // Called when a discarded tab is reloaded, the time until it has loaded
+  // is recorded as the restore time.
+  void OnTabRestoreStarted(content::WebContents* contents);
 
  private:
+  class RestoreObserver;
+
+  // Renderer id => private bytes.
+  using ProcessMemoryMap = std::map<int, uint64_t>;
+
   void ActiveTabChanged(content::WebContents* old_contents,
                         content::WebContents* new_contents,
                         int index,
@@ -46,6 +89,29 @@ class GuestTabManager : public TabManager {
       TabStripModel* model, content::WebContents* old_contents) override;
   void DestroyOldContents(content::WebContents* old_contents) override;
 
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+  void OnMemoryMeasured(
+      base::MemoryPressureListener::MemoryPressureLevel level,
+      std::unique_ptr<ProcessMemoryMap> memory);
+  void OnTabRestored(content::WebContents* contents, base::TimeDelta time);
+
+  std::unique_ptr<base::MemoryPressureListener> discard_pressure_listener_;
+  bool measuring_;
+
+  uint64_t memory_budget_;
+  uint64_t tab_memory_;
+  int discards_;
+  uint64_t reclaimed_bytes_;
+  int restores_;
+  base::TimeDelta total_restore_time_;
+  base::TimeDelta max_restore_time_;
+
+  std::map<content::WebContents*, std::unique_ptr<RestoreObserver>>
+      restoring_tabs_;
+
+  base::WeakPtrFactory<GuestTabManager> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(GuestTabManager);
 };
 
@@ -4,11 +4,18 @@
 
 #include "brave/common/extensions/asar_source_map.h"
 
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "atom/common/asar/archive.h"
 #include "atom/common/asar/asar_util.h"
-#include "base/callback.h"
-#include "base/bind.h"
 #include "base/files/file_util.h"
+#include "base/json/string_escape.h"
+#include "base/lazy_instance.h"
 #include "base/strings/string_split.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_restrictions.h"
 #include "gin/converter.h"
 
 namespace brave {
@@ -17,52 +24,64 @@ namespace {
 
 static const char commonjs[] = "muon/module_system/commonjs";
 
-bool IsAsarPath(const base::FilePath& path) {
-  base::FilePath archive;
-  base::FilePath relative;
-  return asar::GetAsarArchivePath(path, &archive, &relative);
+// The parameters of the wrapper ModuleSystem::WrapSource() puts around every
+// module, in the same order, without require and console which the commonjs
+// loader provides itself. They are passed on to the separately compiled
+// module function, names the wrapper doesn't have are undefined.
+const char* const kModuleSystemNames[] = {
+  "define", "requireNative", "requireAsync", "exports", "privates",
+  "apiBridge", "bindingUtil", "getInternalApi", "$Array", "$Function",
+  "$JSON", "$Object", "$RegExp", "$String", "$Error", "$Promise",
+};
+
+// Resolved module files, shared by all environments. Modules ship with the
+// app, so a module is only resolved once per process. Missing modules are
+// not remembered, they may still be created.
+struct ResolvedPathIndex {
+  base::Lock lock;
+  // Keyed by the search paths and the module path.
+  std::map<std::pair<base::FilePath::StringType, base::FilePath>,
+           base::FilePath> files;
+};
+
+base::LazyInstance<ResolvedPathIndex>::Leaky g_resolved_path_index =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool IsFile(const base::FilePath& path) {
+  base::FilePath archive_path;
+  base::FilePath relative_path;
+  if (asar::GetAsarArchivePath(path, &archive_path, &relative_path)) {
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(archive_path);
+    asar::Archive::Stats stats;
+    return archive && archive->Stat(relative_path, &stats) && stats.is_file;
+  }
+  return base::PathExists(path) && !base::DirectoryExists(path);
 }
 
-bool ReadFromPath(
-    base::Callback<bool(const base::FilePath& path, std::string* contents)>,
-    const base::FilePath& file,
-    const base::FilePath& path,
-    std::string* source) {
-  base::FilePath file_path = path.Append(file);
+// Finds the file for |file| in |search_path|, probing the same candidates
+// as require().
+base::FilePath ResolveInSearchPath(const base::FilePath& search_path,
+                                   const base::FilePath& file) {
+  base::FilePath file_path = search_path.Append(file);
   if (!file_path.MatchesExtension(FILE_PATH_LITERAL(".js")))
     file_path = file_path.AddExtension(FILE_PATH_LITERAL("js"));
 
-  base::FilePath module_path1 = path
+  base::FilePath module_path1 = search_path
       .Append(file)
       .Append(FILE_PATH_LITERAL("index"))
       .AddExtension(FILE_PATH_LITERAL("js"));
 
-  base::FilePath module_path2 = path
+  base::FilePath module_path2 = search_path
       .Append(file)
       .Append(file)
       .AddExtension(FILE_PATH_LITERAL("js"));
 
-  return asar::ReadFileToString(file_path, source) ||
-      asar::ReadFileToString(module_path1, source) ||
-      asar::ReadFileToString(module_path2, source);
-}
-
-bool ReadFromSearchPaths(const std::vector<base::FilePath>& search_paths,
-                        const base::FilePath& file_path,
-                        std::string* source) {
-  for (size_t i = 0; i < search_paths.size(); ++i) {
-    if (IsAsarPath(search_paths[i])) {
-      if (!ReadFromPath(base::Bind(&asar::ReadFileToString),
-          file_path, search_paths[i], source))
-        continue;
-    } else {
-      if (!ReadFromPath(base::Bind(&base::ReadFileToString),
-          file_path, search_paths[i], source))
-        continue;
-    }
-    return true;
+  for (const auto& candidate : { file_path, module_path1, module_path2 }) {
+    if (IsFile(candidate))
+      return candidate;
   }
-  return false;
+  return base::FilePath();
 }
 
 const base::FilePath GetFilePath(const std::string& name) {
@@ -104,6 +123,11 @@ const base::FilePath GetFilePath(const std::string& name) {
 AsarSourceMap::AsarSourceMap(
     const std::vector<base::FilePath>& search_paths)
     : search_paths_(search_paths) {
+  for (const auto& search_path : search_paths_) {
+    search_paths_key_ += search_path.value();
+    search_paths_key_ += base::FilePath::kSeparators[0];
+    search_paths_key_ += base::FilePath::kSeparators[0];
+  }
 }
 
 AsarSourceMap::~AsarSourceMap() {
@@ -112,18 +136,26 @@ AsarSourceMap::~AsarSourceMap() {
 v8::Local<v8::String> AsarSourceMap::GetSource(
     v8::Isolate* isolate,
     const std::string& name) const {
+  base::FilePath file;
   std::string source;
-  if (ReadFromSearchPaths(search_paths_, GetFilePath(name), &source)) {
-    if (name != commonjs) {
-      source =
-          "const fn = function (require, module, console) { " + source + " };"
-          "require('" +
-            commonjs +
-          "').require(fn, exports, '" +
-          GetFilePath(name).AsUTF8Unsafe() +
-          "', this);";
+  if (name == commonjs) {
+    if (ReadModule(name, &file, &source))
+      return gin::StringToV8(isolate, source);
+  } else if (Resolve(name, &file)) {
+    // The module body is compiled by moduleLoader.compile() so it can use the
+    // code cache, the module system only runs this loader.
+    std::string names;
+    for (const char* module_system_name : kModuleSystemNames) {
+      if (!names.empty())
+        names += ", ";
+      names += std::string("typeof ") + module_system_name +
+          " === 'undefined' ? undefined : " + module_system_name;
     }
-
+    source =
+        "require('" + std::string(commonjs) + "').requireModule(" +
+        base::GetQuotedJSONString(name) + ", exports, " +
+        base::GetQuotedJSONString(GetFilePath(name).AsUTF8Unsafe()) +
+        ", this, [" + names + "]);";
     return gin::StringToV8(isolate, source);
   }
 
@@ -132,8 +164,59 @@ v8::Local<v8::String> AsarSourceMap::GetSource(
 }
 
 bool AsarSourceMap::Contains(const std::string& name) const {
-  std::string source;
-  return ReadFromSearchPaths(search_paths_, GetFilePath(name), &source);
+  base::FilePath file;
+  return Resolve(name, &file);
+}
+
+bool AsarSourceMap::Resolve(const std::string& name,
+                            base::FilePath* file) const {
+  base::FilePath path = GetFilePath(name);
+  ResolvedPathIndex& index = g_resolved_path_index.Get();
+  auto key = std::make_pair(search_paths_key_, path);
+  {
+    base::AutoLock auto_lock(index.lock);
+    auto it = index.files.find(key);
+    if (it != index.files.end()) {
+      *file = it->second;
+      return true;
+    }
+  }
+
+  base::FilePath resolved;
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    for (const auto& search_path : search_paths_) {
+      resolved = ResolveInSearchPath(search_path, path);
+      if (!resolved.empty())
+        break;
+    }
+  }
+  if (resolved.empty())
+    return false;
+
+  {
+    base::AutoLock auto_lock(index.lock);
+    index.files[key] = resolved;
+  }
+  *file = resolved;
+  return true;
+}
+
+bool AsarSourceMap::ReadModule(const std::string& name,
+                               base::FilePath* file,
+                               std::string* source) const {
+  if (!Resolve(name, file))
+    return false;
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  return asar::ReadFileToString(*file, source);
+}
+
+std::string AsarSourceMap::WrapModule(const std::string& source) {
+  std::string params = "require, module, console";
+  for (const char* module_system_name : kModuleSystemNames)
+    params += std::string(", ") + module_system_name;
+  // The module system runs modules in strict mode.
+  return "(function (" + params + ") {'use strict';" + source + "\n})";
 }
 
 }  // namespace brave
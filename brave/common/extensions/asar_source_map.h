@@ -24,8 +24,24 @@ class AsarSourceMap : public extensions::SourceMap {
                                  const std::string& name) const override;
   bool Contains(const std::string& name) const override;
 
+  // Finds the file of module |name| without reading it. Modules that were
+  // found are cached for the lifetime of the process.
+  bool Resolve(const std::string& name, base::FilePath* file) const;
+
+  // Reads the source of module |name| and the |file| it comes from.
+  bool ReadModule(const std::string& name,
+                  base::FilePath* file,
+                  std::string* source) const;
+
+  // Turns the |source| of a module into a function expression that takes
+  // require, module and console, followed by the names bound by the module
+  // system.
+  static std::string WrapModule(const std::string& source);
+
  private:
   std::vector<base::FilePath> search_paths_;
+  // Identifies |search_paths_| in the index of resolved modules.
+  base::FilePath::StringType search_paths_key_;
 
   DISALLOW_COPY_AND_ASSIGN(AsarSourceMap);
 };
@@ -2,19 +2,23 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <algorithm>
+#include <set>
 #include <string>
 #include <utility>
 
 #include "brave/common/extensions/file_bindings.h"
 
 #include "base/files/file_util.h"
-#include "base/files/important_file_writer.h"
+#include "base/lazy_instance.h"
+#include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/sequenced_task_runner.h"
 #include "base/task_scheduler/post_task.h"
-#include "base/threading/sequenced_task_runner_handle.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "brave/common/converters/string16_converter.h"
+#include "brave/common/extensions/important_file_writer_registry.h"
+#include "brave/common/extensions/journaled_store.h"
 #include "content/public/browser/browser_thread.h"
 #include "extensions/renderer/script_context.h"
 #include "extensions/renderer/v8_helpers.h"
@@ -26,14 +30,51 @@ namespace brave {
 
 namespace {
 
-void PostWriteCallback(
-    const base::Callback<void(bool success)>& callback,
-    scoped_refptr<base::SequencedTaskRunner> reply_task_runner,
-    bool write_success) {
-  // We can't run |callback| on the current thread. Bounce back to
-  // the |reply_task_runner| which is the correct sequenced thread.
-  reply_task_runner->PostTask(FROM_HERE,
-                              base::Bind(callback, write_success));
+// Writes are committed immediately unless a commit interval is passed.
+const int kDefaultCommitIntervalMs = 0;
+
+base::LazyInstance<std::set<FileBindings*>>::Leaky g_file_bindings =
+    LAZY_INSTANCE_INITIALIZER;
+
+bool GetAbsolutePath(v8::Isolate* isolate,
+                     v8::Local<v8::Value> value,
+                     base::FilePath* path) {
+  base::FilePath::StringType path_name;
+  if (!value->IsString() ||
+      !gin::Converter<base::FilePath::StringType>::FromV8(
+          isolate, value, &path_name)) {
+    isolate->ThrowException(v8::String::NewFromUtf8(
+        isolate, "`path` must be a string"));
+    return false;
+  }
+  *path = base::FilePath(path_name);
+  if (!path->IsAbsolute()) {
+    isolate->ThrowException(v8::String::NewFromUtf8(
+        isolate, "`path` must be absolute"));
+    return false;
+  }
+  return true;
+}
+
+// Copies the string once, straight into the buffer that gets written.
+std::unique_ptr<std::string> ToUTF8(v8::Local<v8::String> string) {
+  std::unique_ptr<std::string> data(
+      new std::string(string->Utf8Length(), '\0'));
+  if (!data->empty()) {
+    string->WriteUtf8(&(*data)[0], data->size(), nullptr,
+                      v8::String::NO_NULL_TERMINATION);
+  }
+  return data;
+}
+
+std::unique_ptr<v8::Global<v8::Function>> GetCallback(
+    const v8::FunctionCallbackInfo<v8::Value>& args, int index) {
+  std::unique_ptr<v8::Global<v8::Function>> callback;
+  if (args.Length() > index && args[index]->IsFunction()) {
+    callback.reset(new v8::Global<v8::Function>(
+        args.GetIsolate(), args[index].As<v8::Function>()));
+  }
+  return callback;
 }
 
 }  // namespace
@@ -42,12 +83,31 @@ FileBindings::FileBindings(extensions::ScriptContext* context)
     : extensions::ObjectBackedNativeHandler(context),
       file_task_runner_(base::CreateSequencedTaskRunnerWithTraits(
           {base::MayBlock(), base::TaskPriority::BACKGROUND,
-            base::TaskShutdownBehavior::BLOCK_SHUTDOWN})) {
+            base::TaskShutdownBehavior::BLOCK_SHUTDOWN})),
+      writers_(new ImportantFileWriterRegistry(file_task_runner_)) {
   RouteFunction("WriteImportantFile",
       base::Bind(&FileBindings::WriteImportantFile, base::Unretained(this)));
+  RouteFunction("GetWriterStats",
+      base::Bind(&FileBindings::GetWriterStats, base::Unretained(this)));
+  RouteFunction("OpenJournal",
+      base::Bind(&FileBindings::OpenJournal, base::Unretained(this)));
+  RouteFunction("JournalSet",
+      base::Bind(&FileBindings::JournalSet, base::Unretained(this)));
+  RouteFunction("JournalDelete",
+      base::Bind(&FileBindings::JournalDelete, base::Unretained(this)));
+  RouteFunction("FlushJournal",
+      base::Bind(&FileBindings::FlushJournal, base::Unretained(this)));
+  g_file_bindings.Get().insert(this);
 }
 
 FileBindings::~FileBindings() {
+  g_file_bindings.Get().erase(this);
+}
+
+// static
+void FileBindings::CommitPendingWrites() {
+  for (FileBindings* bindings : g_file_bindings.Get())
+    bindings->writers_->CommitPendingWrites();
 }
 
 // static
@@ -60,6 +120,16 @@ v8::Local<v8::Object> FileBindings::API(
   v8::Local<v8::Object> file_api = v8::Object::New(context->isolate());
   context->module_system()->SetNativeLazyField(
         file_api, "writeImportant", "muon_file", "WriteImportantFile");
+  context->module_system()->SetNativeLazyField(
+        file_api, "getWriterStats", "muon_file", "GetWriterStats");
+  context->module_system()->SetNativeLazyField(
+        file_api, "openJournal", "muon_file", "OpenJournal");
+  context->module_system()->SetNativeLazyField(
+        file_api, "journalSet", "muon_file", "JournalSet");
+  context->module_system()->SetNativeLazyField(
+        file_api, "journalDelete", "muon_file", "JournalDelete");
+  context->module_system()->SetNativeLazyField(
+        file_api, "flushJournal", "muon_file", "FlushJournal");
 
   return file_api;
 }
@@ -75,44 +145,154 @@ void FileBindings::WriteImportantFile(
     return;
   }
 
-  base::FilePath::StringType path_name;
-  if (!args[0]->IsString() ||
-      !gin::Converter<base::FilePath::StringType>::FromV8(
-          isolate, args[0], &path_name)) {
+  base::FilePath path;
+  if (!GetAbsolutePath(isolate, args[0], &path))
+    return;
+
+  if (!args[1]->IsString()) {
     isolate->ThrowException(v8::String::NewFromUtf8(
-        isolate, "`path` must be a string"));
+        isolate, "`data` must be a string"));
     return;
   }
-  base::FilePath path(path_name);
-  if (!path.IsAbsolute()) {
-    isolate->ThrowException(v8::String::NewFromUtf8(
-        isolate, "`path` must be absolute"));
+  std::unique_ptr<std::string> data = ToUTF8(args[1].As<v8::String>());
+  std::unique_ptr<v8::Global<v8::Function>> callback = GetCallback(args, 2);
+
+  int64_t commit_interval_ms = kDefaultCommitIntervalMs;
+  if (args.Length() > 3 && args[3]->IsObject()) {
+    v8::Local<v8::Value> value;
+    if (args[3].As<v8::Object>()->Get(context()->v8_context(),
+            v8::String::NewFromUtf8(isolate, "commitInterval"))
+            .ToLocal(&value) && value->IsNumber()) {
+      commit_interval_ms = std::max<int64_t>(
+          0, static_cast<int64_t>(value.As<v8::Number>()->Value()));
+    }
   }
 
-  if (!args[1]->IsString()) {
+  writers_->Write(path, std::move(data),
+      base::TimeDelta::FromMilliseconds(commit_interval_ms),
+      base::Bind(&FileBindings::RunCallback, AsWeakPtr(),
+          base::Passed(&callback)));
+}
+
+void FileBindings::GetWriterStats(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = args.GetIsolate();
+  ImportantFileWriterRegistry::Stats stats = writers_->GetStats();
+
+  v8::Local<v8::Object> result = v8::Object::New(isolate);
+  auto set = [&](const char* key, double value) {
+    result->Set(v8::String::NewFromUtf8(isolate, key),
+                v8::Number::New(isolate, value));
+  };
+  set("requestedWrites", stats.requested_writes);
+  set("writes", stats.writes);
+  set("coalescedWrites", stats.coalesced_writes);
+  set("failedWrites", stats.failed_writes);
+  set("bytesWritten", stats.bytes_written);
+  set("averageWriteMs", stats.average_write_time.InMillisecondsF());
+  set("maxWriteMs", stats.max_write_time.InMillisecondsF());
+  args.GetReturnValue().Set(result);
+}
+
+void FileBindings::OpenJournal(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = args.GetIsolate();
+
+  base::FilePath path;
+  if (!GetAbsolutePath(isolate, args[0], &path))
+    return;
+
+  GetJournal(path)->Load(base::Bind(&FileBindings::OnJournalLoaded,
+                                    AsWeakPtr(),
+                                    base::Passed(GetCallback(args, 1))));
+}
+
+void FileBindings::JournalSet(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = args.GetIsolate();
+
+  base::FilePath path;
+  if (!GetAbsolutePath(isolate, args[0], &path))
+    return;
+
+  if (args.Length() < 3 || !args[1]->IsString() || !args[2]->IsString()) {
     isolate->ThrowException(v8::String::NewFromUtf8(
-        isolate, "`data` must be a string"));
+        isolate, "`key` and `value` must be strings"));
     return;
   }
-  std::string data = *v8::String::Utf8Value(args[1]);
 
-  std::unique_ptr<v8::Global<v8::Function>> callback;
-  if (args.Length() > 2 && args[2]->IsFunction()) {
-    callback.reset(
-        new v8::Global<v8::Function>(isolate, args[2].As<v8::Function>()));
+  GetJournal(path)->Set(ToUTF8(args[1].As<v8::String>()),
+                        ToUTF8(args[2].As<v8::String>()));
+}
+
+void FileBindings::JournalDelete(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = args.GetIsolate();
+
+  base::FilePath path;
+  if (!GetAbsolutePath(isolate, args[0], &path))
+    return;
+
+  if (args.Length() < 2 || !args[1]->IsString()) {
+    isolate->ThrowException(v8::String::NewFromUtf8(
+        isolate, "`key` must be a string"));
+    return;
   }
 
-  base::ImportantFileWriter writer(path, file_task_runner_);
+  GetJournal(path)->Delete(ToUTF8(args[1].As<v8::String>()));
+}
+
+void FileBindings::FlushJournal(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = args.GetIsolate();
 
-  writer.RegisterOnNextWriteCallbacks(
-      base::Closure(),
-      base::Bind(
-        &PostWriteCallback,
-        base::Bind(&FileBindings::RunCallback, AsWeakPtr(),
-            base::Passed(&callback)),
-        base::SequencedTaskRunnerHandle::Get()));
+  base::FilePath path;
+  if (!GetAbsolutePath(isolate, args[0], &path))
+    return;
 
-  writer.WriteNow(base::MakeUnique<std::string>(data));
+  GetJournal(path)->Flush(base::Bind(&FileBindings::RunCallback, AsWeakPtr(),
+                                     base::Passed(GetCallback(args, 1))));
+}
+
+JournaledStore* FileBindings::GetJournal(const base::FilePath& path) {
+  scoped_refptr<JournaledStore>& journal = journals_[path];
+  if (!journal)
+    journal = new JournaledStore(path, file_task_runner_);
+  return journal.get();
+}
+
+void FileBindings::OnJournalLoaded(
+    std::unique_ptr<v8::Global<v8::Function>> callback,
+    std::unique_ptr<JournaledStore::Entries> entries) {
+  if (!context()->is_valid() || !callback.get() || callback->IsEmpty())
+    return;
+
+  auto isolate = context()->isolate();
+  v8::HandleScope handle_scope(isolate);
+
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Context::Scope context_scope(v8_context);
+
+  // Keys come from the file, so none of them ("__proto__" included) may
+  // reach a prototype.
+  v8::Local<v8::Object> result =
+      v8::Object::New(isolate, v8::Null(isolate), nullptr, nullptr, 0);
+  for (const auto& entry : *entries) {
+    v8::Local<v8::String> key;
+    v8::Local<v8::String> value;
+    if (!v8::String::NewFromUtf8(isolate, entry.first.data(),
+            v8::NewStringType::kNormal,
+            static_cast<int>(entry.first.size())).ToLocal(&key) ||
+        !v8::String::NewFromUtf8(isolate, entry.second.data(),
+            v8::NewStringType::kNormal,
+            static_cast<int>(entry.second.size())).ToLocal(&value))
+      continue;
+    ignore_result(result->CreateDataProperty(v8_context, key, value));
+  }
+
+  v8::Local<v8::Value> callback_args[] = { result };
+  context()->SafeCallFunction(
+      v8::Local<v8::Function>::New(isolate, *callback), 1, callback_args);
 }
 
 void FileBindings::RunCallback(
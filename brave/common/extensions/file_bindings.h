@@ -5,22 +5,26 @@
 #ifndef BRAVE_COMMON_EXTENSIONS_FILE_BINDINGS_H_
 #define BRAVE_COMMON_EXTENSIONS_FILE_BINDINGS_H_
 
+#include <map>
 #include <memory>
 
 #include "base/compiler_specific.h"
+#include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "brave/common/extensions/journaled_store.h"
 #include "extensions/renderer/object_backed_native_handler.h"
 #include "v8/include/v8.h"
 
 namespace base {
-class FilePath;
 class SequencedTaskRunner;
 class SequencedWorkerPool;
 }
 
 namespace brave {
 
+class ImportantFileWriterRegistry;
+
 class FileBindings : public extensions::ObjectBackedNativeHandler,
                      public base::SupportsWeakPtr<FileBindings> {
  public:
@@ -29,12 +33,27 @@ class FileBindings : public extensions::ObjectBackedNativeHandler,
 
   static v8::Local<v8::Object> API(extensions::ScriptContext* context);
 
+  // Starts the pending writes of every instance. The bindings of the browser
+  // process are leaked on exit, so this has to run before the file task runner
+  // is shut down.
+  static void CommitPendingWrites();
+
  private:
   void WriteImportantFile(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void GetWriterStats(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void OpenJournal(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void JournalSet(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void JournalDelete(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void FlushJournal(const v8::FunctionCallbackInfo<v8::Value>& args);
+  JournaledStore* GetJournal(const base::FilePath& path);
+  void OnJournalLoaded(std::unique_ptr<v8::Global<v8::Function>> callback,
+                       std::unique_ptr<JournaledStore::Entries> entries);
   void RunCallback(
       std::unique_ptr<v8::Global<v8::Function>> holder, bool success);
 
   const scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+  std::unique_ptr<ImportantFileWriterRegistry> writers_;
+  std::map<base::FilePath, scoped_refptr<JournaledStore>> journals_;
 
   DISALLOW_COPY_AND_ASSIGN(FileBindings);
 };
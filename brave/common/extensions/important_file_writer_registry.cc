@@ -0,0 +1,181 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/important_file_writer_registry.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/important_file_writer.h"
+#include "base/sequenced_task_runner.h"
+#include "base/threading/sequenced_task_runner_handle.h"
+
+namespace brave {
+
+namespace {
+
+using WriteStart = base::RefCountedData<base::TimeTicks>;
+
+// Runs on the file sequence.
+void MarkWriteStart(scoped_refptr<WriteStart> start) {
+  start->data = base::TimeTicks::Now();
+}
+
+// Runs on the file sequence, bounces the result back to |reply_task_runner|.
+void PostWriteDone(
+    scoped_refptr<base::SequencedTaskRunner> reply_task_runner,
+    const base::Callback<void(bool, base::TimeDelta)>& callback,
+    scoped_refptr<WriteStart> start,
+    bool success) {
+  reply_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(callback, success, base::TimeTicks::Now() - start->data));
+}
+
+}  // namespace
+
+class ImportantFileWriterRegistry::Writer
+    : public base::ImportantFileWriter::DataSerializer {
+ public:
+  Writer(ImportantFileWriterRegistry* registry,
+         const base::FilePath& path,
+         base::TimeDelta commit_interval)
+      : registry_(registry),
+        writer_(path, registry->task_runner_, commit_interval) {}
+
+  ~Writer() override {
+    CommitPendingWrite();
+  }
+
+  void CommitPendingWrite() {
+    if (writer_.HasPendingWrite())
+      writer_.DoScheduledWrite();
+  }
+
+  base::TimeDelta commit_interval() const {
+    return writer_.commit_interval();
+  }
+
+  void Write(std::unique_ptr<std::string> data,
+             const WriteCallback& callback) {
+    if (data_)
+      ++registry_->coalesced_writes_;
+    data_ = std::move(data);
+    callbacks_.push_back(callback);
+
+    writer_.ScheduleWrite(this);
+    if (writer_.commit_interval().is_zero())
+      writer_.DoScheduledWrite();
+  }
+
+  // base::ImportantFileWriter::DataSerializer:
+  bool SerializeData(std::string* data) override {
+    if (!data_)
+      return false;
+    data->swap(*data_);
+    data_.reset();
+
+    std::vector<WriteCallback> callbacks;
+    callbacks.swap(callbacks_);
+    scoped_refptr<WriteStart> start(new WriteStart);
+    writer_.RegisterOnNextWriteCallbacks(
+        base::Bind(&MarkWriteStart, start),
+        base::Bind(&PostWriteDone, base::SequencedTaskRunnerHandle::Get(),
+                   base::Bind(&ImportantFileWriterRegistry::OnWriteDone,
+                              registry_->weak_factory_.GetWeakPtr(),
+                              callbacks, data->size()),
+                   start));
+    return true;
+  }
+
+ private:
+  ImportantFileWriterRegistry* registry_;
+  base::ImportantFileWriter writer_;
+
+  // The data of the next write and the callbacks of the writes it replaced.
+  std::unique_ptr<std::string> data_;
+  std::vector<WriteCallback> callbacks_;
+
+  DISALLOW_COPY_AND_ASSIGN(Writer);
+};
+
+ImportantFileWriterRegistry::Stats::Stats()
+    : requested_writes(0),
+      writes(0),
+      coalesced_writes(0),
+      failed_writes(0),
+      bytes_written(0) {
+}
+
+ImportantFileWriterRegistry::ImportantFileWriterRegistry(
+    scoped_refptr<base::SequencedTaskRunner> task_runner)
+    : task_runner_(task_runner),
+      requested_writes_(0),
+      writes_(0),
+      coalesced_writes_(0),
+      failed_writes_(0),
+      bytes_written_(0),
+      weak_factory_(this) {
+}
+
+ImportantFileWriterRegistry::~ImportantFileWriterRegistry() {
+  // The writers commit their pending writes when they are destroyed.
+  writers_.clear();
+}
+
+void ImportantFileWriterRegistry::Write(const base::FilePath& path,
+                                        std::unique_ptr<std::string> data,
+                                        base::TimeDelta commit_interval,
+                                        const WriteCallback& callback) {
+  ++requested_writes_;
+
+  std::unique_ptr<Writer>& writer = writers_[path];
+  if (writer && writer->commit_interval() != commit_interval)
+    writer.reset();
+  if (!writer)
+    writer.reset(new Writer(this, path, commit_interval));
+  writer->Write(std::move(data), callback);
+}
+
+void ImportantFileWriterRegistry::CommitPendingWrites() {
+  for (const auto& writer : writers_)
+    writer.second->CommitPendingWrite();
+}
+
+ImportantFileWriterRegistry::Stats
+ImportantFileWriterRegistry::GetStats() const {
+  Stats stats;
+  stats.requested_writes = requested_writes_;
+  stats.writes = writes_;
+  stats.coalesced_writes = coalesced_writes_;
+  stats.failed_writes = failed_writes_;
+  stats.bytes_written = bytes_written_;
+  if (writes_)
+    stats.average_write_time = total_write_time_ / writes_;
+  stats.max_write_time = max_write_time_;
+  return stats;
+}
+
+void ImportantFileWriterRegistry::OnWriteDone(
+    const std::vector<WriteCallback>& callbacks,
+    size_t bytes,
+    bool success,
+    base::TimeDelta time) {
+  ++writes_;
+  if (success)
+    bytes_written_ += bytes;
+  else
+    ++failed_writes_;
+  total_write_time_ += time;
+  max_write_time_ = std::max(max_write_time_, time);
+
+  for (const auto& callback : callbacks) {
+    if (!callback.is_null())
+      callback.Run(success);
+  }
+}
+
+}  // namespace brave
@@ -0,0 +1,96 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_IMPORTANT_FILE_WRITER_REGISTRY_H_
+#define BRAVE_COMMON_EXTENSIONS_IMPORTANT_FILE_WRITER_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace brave {
+
+// Keeps an ImportantFileWriter per path, so the frequent writes of a file are
+// coalesced. A write is committed at most |commit_interval| after it has been
+// requested, and only the last data passed for the path in the meantime is
+// written.
+class ImportantFileWriterRegistry {
+ public:
+  using WriteCallback = base::Callback<void(bool success)>;
+
+  struct Stats {
+    Stats();
+
+    uint64_t requested_writes;
+    uint64_t writes;
+    // Requested writes whose data was replaced before it was written.
+    uint64_t coalesced_writes;
+    uint64_t failed_writes;
+    uint64_t bytes_written;
+    // Time to write the temporary file, flush it and rename it.
+    base::TimeDelta average_write_time;
+    base::TimeDelta max_write_time;
+  };
+
+  explicit ImportantFileWriterRegistry(
+      scoped_refptr<base::SequencedTaskRunner> task_runner);
+  // Commits the pending writes.
+  ~ImportantFileWriterRegistry();
+
+  // Replaces the pending data of |path|. |callback| is run on the current
+  // sequence once the data, or the data which replaced it, has been written.
+  // The commit interval of a path is changed by the next write if it differs,
+  // a zero interval writes immediately.
+  void Write(const base::FilePath& path,
+             std::unique_ptr<std::string> data,
+             base::TimeDelta commit_interval,
+             const WriteCallback& callback);
+
+  // Starts the pending writes now, whatever their commit interval.
+  void CommitPendingWrites();
+
+  Stats GetStats() const;
+
+ private:
+  class Writer;
+
+  // Runs the callbacks of a write.
+  void OnWriteDone(const std::vector<WriteCallback>& callbacks,
+                   size_t bytes,
+                   bool success,
+                   base::TimeDelta time);
+
+  const scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  std::map<base::FilePath, std::unique_ptr<Writer>> writers_;
+
+  uint64_t requested_writes_;
+  uint64_t writes_;
+  uint64_t coalesced_writes_;
+  uint64_t failed_writes_;
+  uint64_t bytes_written_;
+  base::TimeDelta total_write_time_;
+  base::TimeDelta max_write_time_;
+
+  base::WeakPtrFactory<ImportantFileWriterRegistry> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ImportantFileWriterRegistry);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_IMPORTANT_FILE_WRITER_REGISTRY_H_
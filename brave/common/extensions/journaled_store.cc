@@ -0,0 +1,258 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/journaled_store.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/hash.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/pickle.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_runner_util.h"
+
+namespace brave {
+
+namespace {
+
+enum RecordType {
+  RECORD_SET = 1,
+  RECORD_DELETE = 2,
+};
+
+const base::FilePath::CharType kJournalSuffix[] =
+    FILE_PATH_LITERAL(".journal");
+
+// The journal is never compacted below this size, so small stores don't
+// rewrite their checkpoint all the time.
+const uint64_t kMinCompactionSize = 256 * 1024;
+
+void AppendRecord(RecordType type,
+                  const std::string& key,
+                  const std::string* value,
+                  std::string* out) {
+  base::Pickle pickle;
+  pickle.WriteInt(type);
+  pickle.WriteString(key);
+  if (value)
+    pickle.WriteString(*value);
+
+  uint32_t hash = base::Hash(static_cast<const char*>(pickle.data()),
+                             pickle.size());
+  out->append(static_cast<const char*>(pickle.data()), pickle.size());
+  out->append(reinterpret_cast<const char*>(&hash), sizeof(hash));
+}
+
+}  // namespace
+
+JournaledStore::JournaledStore(
+    const base::FilePath& path,
+    scoped_refptr<base::SequencedTaskRunner> file_task_runner)
+    : base::RefCountedDeleteOnSequence<JournaledStore>(file_task_runner),
+      path_(path),
+      journal_path_(path.AddExtension(kJournalSuffix)),
+      file_task_runner_(file_task_runner),
+      loaded_(false),
+      entries_size_(0),
+      journal_size_(0) {
+}
+
+JournaledStore::~JournaledStore() {
+}
+
+void JournaledStore::Load(const LoadCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::Bind(&JournaledStore::LoadOnFileSequence, this), callback);
+}
+
+void JournaledStore::Set(std::unique_ptr<std::string> key,
+                         std::unique_ptr<std::string> value) {
+  file_task_runner_->PostTask(FROM_HERE,
+      base::Bind(&JournaledStore::SetOnFileSequence, this,
+                 base::Passed(&key), base::Passed(&value)));
+}
+
+void JournaledStore::Delete(std::unique_ptr<std::string> key) {
+  file_task_runner_->PostTask(FROM_HERE,
+      base::Bind(&JournaledStore::DeleteOnFileSequence, this,
+                 base::Passed(&key)));
+}
+
+void JournaledStore::Flush(const FlushCallback& callback) {
+  base::PostTaskAndReplyWithResult(
+      file_task_runner_.get(), FROM_HERE,
+      base::Bind(&JournaledStore::FlushOnFileSequence, this), callback);
+}
+
+void JournaledStore::EnsureLoaded() {
+  DCHECK(file_task_runner_->RunsTasksInCurrentSequence());
+  if (loaded_)
+    return;
+  loaded_ = true;
+
+  std::string checkpoint;
+  if (base::ReadFileToString(path_, &checkpoint))
+    Replay(checkpoint);
+
+  std::string journal;
+  size_t journal_size = 0;
+  if (base::ReadFileToString(journal_path_, &journal))
+    journal_size = Replay(journal);
+
+  journal_.Initialize(journal_path_,
+                      base::File::FLAG_OPEN_ALWAYS | base::File::FLAG_WRITE);
+  if (!journal_.IsValid()) {
+    LOG(ERROR) << "Failed to open " << journal_path_.value();
+    return;
+  }
+  // Drop a record torn by a crash, the next ones would be lost behind it.
+  if (journal_size != journal.size())
+    journal_.SetLength(journal_size);
+  journal_.Seek(base::File::FROM_BEGIN, journal_size);
+  journal_size_ = journal_size;
+
+  MaybeCompact();
+}
+
+size_t JournaledStore::Replay(const std::string& data) {
+  const size_t kOverhead = sizeof(base::Pickle::Header) + sizeof(uint32_t);
+
+  size_t offset = 0;
+  while (data.size() - offset >= kOverhead) {
+    const char* start = data.data() + offset;
+    uint32_t payload_size;
+    memcpy(&payload_size, start, sizeof(payload_size));
+    if (payload_size > data.size() - offset - kOverhead)
+      break;
+
+    size_t pickle_size = sizeof(base::Pickle::Header) + payload_size;
+    uint32_t hash;
+    memcpy(&hash, start + pickle_size, sizeof(hash));
+    if (hash != base::Hash(start, pickle_size))
+      break;
+
+    base::Pickle pickle(start, static_cast<int>(pickle_size));
+    base::PickleIterator iter(pickle);
+    int type;
+    std::string key;
+    if (!iter.ReadInt(&type) || !iter.ReadString(&key))
+      break;
+    if (type == RECORD_SET) {
+      std::string value;
+      if (!iter.ReadString(&value))
+        break;
+      ApplySet(std::move(key), std::move(value));
+    } else if (type == RECORD_DELETE) {
+      ApplyDelete(key);
+    } else {
+      break;
+    }
+    offset += pickle_size + sizeof(hash);
+  }
+  return offset;
+}
+
+void JournaledStore::ApplySet(std::string key, std::string value) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    entries_size_ += key.size() + value.size();
+    entries_.emplace(std::move(key), std::move(value));
+    return;
+  }
+  entries_size_ -= it->second.size();
+  entries_size_ += value.size();
+  it->second = std::move(value);
+}
+
+void JournaledStore::ApplyDelete(const std::string& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end())
+    return;
+  entries_size_ -= it->first.size() + it->second.size();
+  entries_.erase(it);
+}
+
+std::unique_ptr<JournaledStore::Entries>
+JournaledStore::LoadOnFileSequence() {
+  EnsureLoaded();
+  return base::MakeUnique<Entries>(entries_);
+}
+
+void JournaledStore::SetOnFileSequence(std::unique_ptr<std::string> key,
+                                       std::unique_ptr<std::string> value) {
+  EnsureLoaded();
+  std::string record;
+  AppendRecord(RECORD_SET, *key, value.get(), &record);
+  ApplySet(std::move(*key), std::move(*value));
+  Append(record);
+}
+
+void JournaledStore::DeleteOnFileSequence(std::unique_ptr<std::string> key) {
+  EnsureLoaded();
+  if (!entries_.count(*key))
+    return;
+  std::string record;
+  AppendRecord(RECORD_DELETE, *key, nullptr, &record);
+  ApplyDelete(*key);
+  Append(record);
+}
+
+bool JournaledStore::FlushOnFileSequence() {
+  EnsureLoaded();
+  return journal_.IsValid() && journal_.Flush();
+}
+
+void JournaledStore::Append(const std::string& record) {
+  if (!journal_.IsValid())
+    return;
+
+  int written = journal_.WriteAtCurrentPos(record.data(),
+                                           static_cast<int>(record.size()));
+  if (written != static_cast<int>(record.size())) {
+    LOG(ERROR) << "Failed to append to " << journal_path_.value();
+    // Don't leave a partial record for the next ones to hide behind, the
+    // change is still in the checkpoint written by the next compaction.
+    journal_.SetLength(journal_size_);
+    journal_.Seek(base::File::FROM_BEGIN, journal_size_);
+    return;
+  }
+  journal_size_ += record.size();
+
+  MaybeCompact();
+}
+
+void JournaledStore::MaybeCompact() {
+  // Compacting once the journal is as big as the state keeps the cost of a
+  // checkpoint proportional to the size of the changes that led to it.
+  if (journal_size_ < std::max(kMinCompactionSize, entries_size_))
+    return;
+  Compact();
+}
+
+void JournaledStore::Compact() {
+  std::string checkpoint;
+  for (const auto& entry : entries_)
+    AppendRecord(RECORD_SET, entry.first, &entry.second, &checkpoint);
+
+  if (!base::ImportantFileWriter::WriteFileAtomically(path_, checkpoint))
+    return;
+
+  // Replaying the old journal on top of the new checkpoint gives the same
+  // state, so a crash before it is truncated is harmless.
+  if (journal_.IsValid()) {
+    journal_.SetLength(0);
+    journal_.Seek(base::File::FROM_BEGIN, 0);
+  }
+  journal_size_ = 0;
+}
+
+}  // namespace brave
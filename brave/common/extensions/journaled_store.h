@@ -0,0 +1,96 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_JOURNALED_STORE_H_
+#define BRAVE_COMMON_EXTENSIONS_JOURNALED_STORE_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/callback.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted_delete_on_sequence.h"
+
+namespace base {
+class SequencedTaskRunner;
+}
+
+namespace brave {
+
+// A string key/value store persisted as a checkpoint file plus a journal of
+// the changes made since, so the cost of a change depends on its size rather
+// than on the size of the whole state.
+//
+// The checkpoint lives at |path| and the journal next to it with a
+// ".journal" suffix. Every record is a pickle followed by its hash, a torn
+// record at the end of the journal is dropped when it is replayed. Once the
+// journal outgrows the state it is compacted into a new checkpoint.
+//
+// The public methods can be called from any sequence, the state itself only
+// lives on the file sequence.
+class JournaledStore
+    : public base::RefCountedDeleteOnSequence<JournaledStore> {
+ public:
+  using Entries = std::map<std::string, std::string>;
+  using LoadCallback = base::Callback<void(std::unique_ptr<Entries>)>;
+  using FlushCallback = base::Callback<void(bool success)>;
+
+  JournaledStore(const base::FilePath& path,
+                 scoped_refptr<base::SequencedTaskRunner> file_task_runner);
+
+  // Replays the checkpoint and the journal, and replies with the entries on
+  // the current sequence. Changes made before are included.
+  void Load(const LoadCallback& callback);
+
+  void Set(std::unique_ptr<std::string> key,
+           std::unique_ptr<std::string> value);
+  void Delete(std::unique_ptr<std::string> key);
+
+  // Replies once the changes made so far are on disk.
+  void Flush(const FlushCallback& callback);
+
+ private:
+  friend class base::RefCountedDeleteOnSequence<JournaledStore>;
+  friend class base::DeleteHelper<JournaledStore>;
+
+  ~JournaledStore();
+
+  // These run on the file sequence.
+  void EnsureLoaded();
+  // Applies the valid records at the start of |data|, returns their size.
+  size_t Replay(const std::string& data);
+  void ApplySet(std::string key, std::string value);
+  void ApplyDelete(const std::string& key);
+  std::unique_ptr<Entries> LoadOnFileSequence();
+  void SetOnFileSequence(std::unique_ptr<std::string> key,
+                         std::unique_ptr<std::string> value);
+  void DeleteOnFileSequence(std::unique_ptr<std::string> key);
+  bool FlushOnFileSequence();
+  void Append(const std::string& record);
+  void MaybeCompact();
+  void Compact();
+
+  const base::FilePath path_;
+  const base::FilePath journal_path_;
+  const scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  bool loaded_;
+  Entries entries_;
+  // Bytes of keys and values in |entries_|.
+  uint64_t entries_size_;
+
+  base::File journal_;
+  uint64_t journal_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(JournaledStore);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_JOURNALED_STORE_H_
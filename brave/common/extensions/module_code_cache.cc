@@ -0,0 +1,259 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/module_code_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/containers/mru_cache.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/path_service.h"
+#include "base/sequenced_task_runner.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task_scheduler/post_task.h"
+#include "base/threading/thread_restrictions.h"
+#include "chrome/common/chrome_paths.h"
+#include "gin/converter.h"
+
+namespace brave {
+
+namespace {
+
+const base::FilePath::CharType kCodeCacheDirName[] =
+    FILE_PATH_LITERAL("ModuleCodeCache");
+
+// Bytes of code cache data kept in memory.
+const size_t kMaxMemorySize = 8 * 1024 * 1024;
+// Bytes of code cache data kept on disk, the files used least recently are
+// deleted first.
+const int64_t kMaxDiskSize = 32 * 1024 * 1024;
+
+// Code cache data already loaded or produced by this process, shared by the
+// browser environment and all workers.
+struct CodeCacheData {
+  using Entries = base::MRUCache<std::string, std::string>;
+
+  CodeCacheData()
+      : entries(Entries::NO_AUTO_EVICT),
+        size(0),
+        pruned(false),
+        file_task_runner(base::CreateSequencedTaskRunnerWithTraits(
+            {base::MayBlock(), base::TaskPriority::BACKGROUND,
+             base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})) {}
+
+  base::Lock lock;
+  Entries entries;
+  // Bytes of data in |entries|.
+  size_t size;
+  // Whether the cache directory has been pruned by this process.
+  bool pruned;
+  // Writes, touches and deletes the cache files.
+  const scoped_refptr<base::SequencedTaskRunner> file_task_runner;
+};
+
+base::LazyInstance<CodeCacheData>::Leaky g_code_cache =
+    LAZY_INSTANCE_INITIALIZER;
+
+std::string GetCacheKey(const base::FilePath& path,
+                        const std::string& source) {
+  std::string hash = base::SHA1HashString(
+      path.AsUTF8Unsafe() + '\n' + v8::V8::GetVersion() + '\n' + source);
+  return base::ToLowerASCII(base::HexEncode(hash.data(), hash.size()));
+}
+
+base::FilePath GetCacheFile(const std::string& key) {
+  base::FilePath user_data_dir;
+  if (!PathService::Get(chrome::DIR_USER_DATA, &user_data_dir))
+    return base::FilePath();
+  return user_data_dir.Append(kCodeCacheDirName).AppendASCII(key);
+}
+
+// |cache.lock| must be held. Drops the entries used least recently once the
+// entries are over kMaxMemorySize.
+void PutEntryLocked(CodeCacheData* cache,
+                    const std::string& key,
+                    const std::string& data) {
+  auto it = cache->entries.Peek(key);
+  if (it != cache->entries.end()) {
+    cache->size -= it->second.size();
+    cache->entries.Erase(it);
+  }
+  cache->entries.Put(key, data);
+  cache->size += data.size();
+
+  while (cache->size > kMaxMemorySize && cache->entries.size() > 1) {
+    auto oldest = cache->entries.rbegin();
+    cache->size -= oldest->second.size();
+    cache->entries.Erase(oldest);
+  }
+}
+
+// These run on the file task runner.
+void WriteCacheFile(const base::FilePath& file, const std::string& data) {
+  // Write to a temporary file first, so a concurrent reader never sees a
+  // partial entry.
+  base::FilePath temp_file;
+  if (!base::CreateDirectory(file.DirName()) ||
+      !base::CreateTemporaryFileInDir(file.DirName(), &temp_file))
+    return;
+  if (base::WriteFile(temp_file, data.data(), data.size()) !=
+          static_cast<int>(data.size()) ||
+      !base::ReplaceFile(temp_file, file, nullptr))
+    base::DeleteFile(temp_file, false);
+}
+
+void TouchCacheFile(const base::FilePath& file) {
+  base::Time now = base::Time::Now();
+  base::TouchFile(file, now, now);
+}
+
+void DeleteCacheFile(const base::FilePath& file) {
+  base::DeleteFile(file, false);
+}
+
+void PruneCacheDir(const base::FilePath& dir) {
+  std::vector<std::tuple<base::Time, int64_t, base::FilePath>> files;
+  int64_t total_size = 0;
+  base::FileEnumerator enumerator(dir, false, base::FileEnumerator::FILES);
+  for (base::FilePath file = enumerator.Next(); !file.empty();
+       file = enumerator.Next()) {
+    base::FileEnumerator::FileInfo info = enumerator.GetInfo();
+    files.emplace_back(info.GetLastModifiedTime(), info.GetSize(), file);
+    total_size += info.GetSize();
+  }
+  if (total_size <= kMaxDiskSize)
+    return;
+
+  std::sort(files.begin(), files.end());
+  for (const auto& file : files) {
+    if (total_size <= kMaxDiskSize)
+      break;
+    if (base::DeleteFile(std::get<2>(file), false))
+      total_size -= std::get<1>(file);
+  }
+}
+
+bool GetCachedData(const std::string& key, std::string* data) {
+  CodeCacheData& cache = g_code_cache.Get();
+  {
+    base::AutoLock auto_lock(cache.lock);
+    auto it = cache.entries.Get(key);
+    if (it != cache.entries.end()) {
+      *data = it->second;
+      return true;
+    }
+  }
+
+  // The data is needed to compile the module, so it is read right away.
+  base::FilePath file = GetCacheFile(key);
+  {
+    base::ThreadRestrictions::ScopedAllowIO allow_io;
+    if (file.empty() || !base::ReadFileToString(file, data))
+      return false;
+  }
+  // Keeps the file from being pruned.
+  cache.file_task_runner->PostTask(FROM_HERE,
+      base::Bind(&TouchCacheFile, file));
+
+  base::AutoLock auto_lock(cache.lock);
+  PutEntryLocked(&cache, key, *data);
+  return true;
+}
+
+void SetCachedData(const std::string& key, const std::string& data) {
+  CodeCacheData& cache = g_code_cache.Get();
+  bool prune;
+  {
+    base::AutoLock auto_lock(cache.lock);
+    PutEntryLocked(&cache, key, data);
+    prune = !cache.pruned;
+    cache.pruned = true;
+  }
+
+  base::FilePath file = GetCacheFile(key);
+  if (file.empty())
+    return;
+
+  cache.file_task_runner->PostTask(FROM_HERE,
+      base::Bind(&WriteCacheFile, file, data));
+  if (prune) {
+    cache.file_task_runner->PostTask(FROM_HERE,
+        base::Bind(&PruneCacheDir, file.DirName()));
+  }
+}
+
+void RemoveCachedData(const std::string& key) {
+  CodeCacheData& cache = g_code_cache.Get();
+  {
+    base::AutoLock auto_lock(cache.lock);
+    auto it = cache.entries.Peek(key);
+    if (it != cache.entries.end()) {
+      cache.size -= it->second.size();
+      cache.entries.Erase(it);
+    }
+  }
+
+  base::FilePath file = GetCacheFile(key);
+  if (!file.empty()) {
+    cache.file_task_runner->PostTask(FROM_HERE,
+        base::Bind(&DeleteCacheFile, file));
+  }
+}
+
+}  // namespace
+
+v8::MaybeLocal<v8::Function> CompileModuleWithCodeCache(
+    v8::Isolate* isolate,
+    const base::FilePath& path,
+    const std::string& wrapped_source) {
+  std::string key = GetCacheKey(path, wrapped_source);
+  std::string data;
+  bool has_data = GetCachedData(key, &data);
+
+  v8::ScriptOrigin origin(gin::StringToV8(isolate, path.AsUTF8Unsafe()));
+  // |source| doesn't own the cached data, |data| outlives it.
+  v8::ScriptCompiler::Source source(
+      gin::StringToV8(isolate, wrapped_source), origin,
+      has_data ? new v8::ScriptCompiler::CachedData(
+                     reinterpret_cast<const uint8_t*>(data.data()),
+                     static_cast<int>(data.size()))
+               : nullptr);
+
+  v8::Local<v8::UnboundScript> script;
+  if (!v8::ScriptCompiler::CompileUnboundScript(
+          isolate, &source,
+          has_data ? v8::ScriptCompiler::kConsumeCodeCache
+                   : v8::ScriptCompiler::kProduceCodeCache)
+          .ToLocal(&script))
+    return v8::MaybeLocal<v8::Function>();
+
+  const v8::ScriptCompiler::CachedData* cached_data = source.GetCachedData();
+  if (has_data && cached_data && cached_data->rejected) {
+    // Produced by another V8 build or with other flags, make a new one on the
+    // next load.
+    RemoveCachedData(key);
+  } else if (!has_data && cached_data && cached_data->length > 0) {
+    SetCachedData(key, std::string(
+        reinterpret_cast<const char*>(cached_data->data),
+        cached_data->length));
+  }
+
+  v8::Local<v8::Value> result;
+  if (!script->BindToCurrentContext()->Run(isolate->GetCurrentContext())
+           .ToLocal(&result) ||
+      !result->IsFunction())
+    return v8::MaybeLocal<v8::Function>();
+  return result.As<v8::Function>();
+}
+
+}  // namespace brave
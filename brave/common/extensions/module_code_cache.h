@@ -0,0 +1,28 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
+#define BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// Compiles the function |wrapped_source| evaluates to, using V8 code cache
+// data that persists across launches in the user data directory. The data is
+// keyed by |path| and a hash of the source, so edited modules are compiled
+// again. New data is written in the background, and the data used least
+// recently is dropped once the cache grows too large. Can be called on any
+// thread with a V8 context.
+v8::MaybeLocal<v8::Function> CompileModuleWithCodeCache(
+    v8::Isolate* isolate,
+    const base::FilePath& path,
+    const std::string& wrapped_source);
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
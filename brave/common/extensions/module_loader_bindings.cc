@@ -0,0 +1,54 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "brave/common/extensions/module_loader_bindings.h"
+
+#include "base/files/file_path.h"
+#include "brave/common/extensions/asar_source_map.h"
+#include "brave/common/extensions/module_code_cache.h"
+#include "extensions/renderer/script_context.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+ModuleLoaderBindings::ModuleLoaderBindings(
+        extensions::ScriptContext* context,
+        const AsarSourceMap* source_map)
+    : extensions::ObjectBackedNativeHandler(context),
+      source_map_(source_map) {
+  RouteFunction("compile",
+              base::Bind(&ModuleLoaderBindings::Compile,
+                         base::Unretained(this)));
+}
+
+ModuleLoaderBindings::~ModuleLoaderBindings() {
+}
+
+void ModuleLoaderBindings::Compile(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  if (args.Length() != 1 || !args[0]->IsString()) {
+    GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+        GetIsolate(), "Invalid arguments to 'compile'"));
+    return;
+  }
+
+  std::string name(*v8::String::Utf8Value(args[0]));
+  base::FilePath file;
+  std::string source;
+  if (!source_map_->ReadModule(name, &file, &source)) {
+    GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+        GetIsolate(), ("Cannot read module '" + name + "'").c_str()));
+    return;
+  }
+
+  // Compile errors have already been thrown.
+  v8::Local<v8::Function> function;
+  if (CompileModuleWithCodeCache(GetIsolate(), file,
+          AsarSourceMap::WrapModule(source)).ToLocal(&function))
+    args.GetReturnValue().Set(function);
+}
+
+}  // namespace brave
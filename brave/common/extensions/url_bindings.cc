@@ -7,6 +7,7 @@
 
 #include "brave/common/extensions/url_bindings.h"
 
+#include "base/strings/string_util.h"
 #include "brave/common/converters/gurl_converter.h"
 #include "brave/common/converters/string16_converter.h"
 #include "components/url_formatter/url_formatter.h"
@@ -266,6 +267,136 @@ class WrappableGURL : public GURL,
 
 gin::WrapperInfo WrappableGURL::kWrapperInfo = { gin::kEmbedderNativeGin };
 
+// The node Url.parse compatible fields of a valid url.
+std::string GetAuth(const GURL& gurl) {
+  return gurl.username() + (gurl.has_password() ? ":" + gurl.password() : "");
+}
+
+std::string GetHash(const GURL& gurl) {
+  return (gurl.has_ref() ? "#" : "") + gurl.ref();
+}
+
+std::string GetHost(const GURL& gurl) {
+  return gurl.host() + (gurl.has_port() ? ":" + gurl.port() : "");
+}
+
+std::string GetProtocol(const GURL& gurl) {
+  return gurl.scheme() + (gurl.has_scheme() ? ":" : "");
+}
+
+std::string GetSearch(const GURL& gurl) {
+  return (gurl.has_query() ? "?" : "") + gurl.query();
+}
+
+// A Url.parse compatible object whose fields are only computed when they are
+// read, all of them are undefined for an invalid url.
+class ParsedURL : public gin::Wrappable<ParsedURL> {
+ public:
+  explicit ParsedURL(base::StringPiece url_string) : gurl_(url_string) {}
+
+  gin::ObjectTemplateBuilder GetObjectTemplateBuilder(
+      v8::Isolate* isolate) override {
+    return gin::Wrappable<ParsedURL>::GetObjectTemplateBuilder(isolate)
+        .SetProperty("auth", &ParsedURL::auth)
+        .SetProperty("hash", &ParsedURL::hash)
+        .SetProperty("hostname", &ParsedURL::hostname)
+        .SetProperty("host", &ParsedURL::host)
+        .SetProperty("href", &ParsedURL::href)
+        .SetProperty("path", &ParsedURL::path)
+        .SetProperty("pathname", &ParsedURL::pathname)
+        .SetProperty("port", &ParsedURL::port)
+        .SetProperty("protocol", &ParsedURL::protocol)
+        .SetProperty("query", &ParsedURL::query)
+        .SetProperty("search", &ParsedURL::search)
+        .SetProperty("origin", &ParsedURL::origin);
+  }
+
+  static gin::WrapperInfo kWrapperInfo;
+
+ private:
+  v8::Local<v8::Value> auth(gin::Arguments* args) {
+    if (!gurl_.has_username())
+      return v8::Undefined(args->isolate());
+    return ToV8(args->isolate(), GetAuth(gurl_));
+  }
+
+  v8::Local<v8::Value> hash(gin::Arguments* args) {
+    return ToV8(args->isolate(), GetHash(gurl_));
+  }
+
+  v8::Local<v8::Value> hostname(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.host());
+  }
+
+  v8::Local<v8::Value> host(gin::Arguments* args) {
+    return ToV8(args->isolate(), GetHost(gurl_));
+  }
+
+  v8::Local<v8::Value> href(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.possibly_invalid_spec());
+  }
+
+  v8::Local<v8::Value> path(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.PathForRequest());
+  }
+
+  v8::Local<v8::Value> pathname(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.path());
+  }
+
+  v8::Local<v8::Value> port(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.port());
+  }
+
+  v8::Local<v8::Value> protocol(gin::Arguments* args) {
+    return ToV8(args->isolate(), GetProtocol(gurl_));
+  }
+
+  v8::Local<v8::Value> query(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.query());
+  }
+
+  v8::Local<v8::Value> search(gin::Arguments* args) {
+    return ToV8(args->isolate(), GetSearch(gurl_));
+  }
+
+  v8::Local<v8::Value> origin(gin::Arguments* args) {
+    return ToV8(args->isolate(), gurl_.GetOrigin().spec());
+  }
+
+  v8::Local<v8::Value> ToV8(v8::Isolate* isolate, const std::string& value) {
+    if (!gurl_.is_valid())
+      return v8::Undefined(isolate);
+    return gin::StringToV8(isolate, value);
+  }
+
+  const GURL gurl_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParsedURL);
+};
+
+gin::WrapperInfo ParsedURL::kWrapperInfo = { gin::kEmbedderNativeGin };
+
+// The url components reported by ParseMany, in order.
+const char* const kComponentNames[] = {
+  "href", "scheme", "username", "password", "host", "port", "path", "query",
+  "ref",
+};
+const size_t kComponentCount = arraysize(kComponentNames);
+
+void SetComponent(int32_t* components,
+                  size_t index,
+                  size_t offset,
+                  const url::Component& component) {
+  if (component.is_valid()) {
+    components[index * 2] = static_cast<int32_t>(offset + component.begin);
+    components[index * 2 + 1] = component.len;
+  } else {
+    components[index * 2] = -1;
+    components[index * 2 + 1] = -1;
+  }
+}
+
 }  // namespace
 
 URLBindings::URLBindings(extensions::ScriptContext* context)
@@ -276,6 +407,10 @@ URLBindings::URLBindings(extensions::ScriptContext* context)
             base::Bind(&URLBindings::FormatForDisplay, base::Unretained(this)));
   RouteFunction("Parse",
             base::Bind(&URLBindings::Parse, base::Unretained(this)));
+  RouteFunction("ParseLazy",
+            base::Bind(&URLBindings::ParseLazy, base::Unretained(this)));
+  RouteFunction("ParseMany",
+            base::Bind(&URLBindings::ParseMany, base::Unretained(this)));
 }
 
 URLBindings::~URLBindings() {
@@ -294,6 +429,10 @@ v8::Local<v8::Object> URLBindings::API(extensions::ScriptContext* context) {
         url_api, "formatForDisplay", "muon_url", "FormatForDisplay");
   context->module_system()->SetNativeLazyField(
         url_api, "parse", "muon_url", "Parse");
+  context->module_system()->SetNativeLazyField(
+        url_api, "parseLazy", "muon_url", "ParseLazy");
+  context->module_system()->SetNativeLazyField(
+        url_api, "parseMany", "muon_url", "ParseMany");
 
   v8::Local<v8::Context> v8_context = context->v8_context();
   v8::Isolate* isolate = v8_context->GetIsolate();
@@ -410,21 +549,119 @@ void URLBindings::Parse(
   gin::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
   if (gurl.is_valid()) {
     if (gurl.has_username())
-      dict.Set("auth", gurl.username() + (gurl.has_password()
-        ? ":" + gurl.password() : ""));
-    dict.Set("hash", (gurl.has_ref() ? "#" : "") + gurl.ref());
+      dict.Set("auth", GetAuth(gurl));
+    dict.Set("hash", GetHash(gurl));
     dict.Set("hostname", gurl.host());
-    dict.Set("host", gurl.host() + (gurl.has_port() ? ":" + gurl.port() : ""));
+    dict.Set("host", GetHost(gurl));
     dict.Set("href", gurl.possibly_invalid_spec());
     dict.Set("path", gurl.PathForRequest());
     dict.Set("pathname", gurl.path());
     dict.Set("port", gurl.port());
-    dict.Set("protocol", gurl.scheme() + (gurl.has_scheme() ? ":" : ""));
+    dict.Set("protocol", GetProtocol(gurl));
     dict.Set("query", gurl.query());
-    dict.Set("search", (gurl.has_query() ? "?" : "") + gurl.query());
+    dict.Set("search", GetSearch(gurl));
     dict.Set("origin", gurl.GetOrigin());
   }
   args.GetReturnValue().Set(gin::ConvertToV8(isolate, dict));
 }
 
+// same as Parse, but the fields are computed when they are read
+void URLBindings::ParseLazy(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = context()->isolate();
+  if (args.Length() != 1) {
+    isolate->ThrowException(v8::String::NewFromUtf8(
+        isolate, "`url` is a required field"));
+    return;
+  }
+
+  std::string url_string = *v8::String::Utf8Value(args[0]);
+  gin::Handle<ParsedURL> parsed = gin::CreateHandle(
+      isolate, new ParsedURL(url_string));
+  args.GetReturnValue().Set(parsed->GetWrapper(isolate).ToLocalChecked());
+}
+
+// Parses an array of urls into columns. The canonical specs of the valid urls
+// are concatenated into one string, |components| has the offset and length
+// of every component of a url in that string, or -1 for both if it is
+// missing. Urls that are invalid, or whose spec isn't ASCII and so can't be
+// indexed the same way from javascript, have all their components missing.
+void URLBindings::ParseMany(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  auto isolate = context()->isolate();
+  if (args.Length() != 1 || !args[0]->IsArray()) {
+    isolate->ThrowException(v8::String::NewFromUtf8(
+        isolate, "`urls` must be an array"));
+    return;
+  }
+
+  v8::Local<v8::Context> v8_context = context()->v8_context();
+  v8::Local<v8::Array> urls = args[0].As<v8::Array>();
+  uint32_t count = urls->Length();
+
+  v8::Local<v8::ArrayBuffer> components_buffer = v8::ArrayBuffer::New(
+      isolate, count * kComponentCount * 2 * sizeof(int32_t));
+  int32_t* components =
+      static_cast<int32_t*>(components_buffer->GetContents().Data());
+  v8::Local<v8::ArrayBuffer> valid_buffer =
+      v8::ArrayBuffer::New(isolate, count);
+  uint8_t* valid = static_cast<uint8_t*>(valid_buffer->GetContents().Data());
+
+  std::string specs;
+  url::Component missing;
+  for (uint32_t i = 0; i < count; ++i) {
+    int32_t* url_components = components + i * kComponentCount * 2;
+
+    v8::Local<v8::Value> value;
+    GURL gurl;
+    if (urls->Get(v8_context, i).ToLocal(&value) && value->IsString())
+      gurl = GURL(*v8::String::Utf8Value(value));
+
+    const std::string& spec = gurl.possibly_invalid_spec();
+    valid[i] = gurl.is_valid() && base::IsStringASCII(spec) &&
+        specs.size() + spec.size() <=
+            static_cast<size_t>(v8::String::kMaxLength);
+    if (!valid[i]) {
+      for (size_t j = 0; j < kComponentCount; ++j)
+        SetComponent(url_components, j, 0, missing);
+      continue;
+    }
+
+    size_t offset = specs.size();
+    specs.append(spec);
+    const url::Parsed& parsed = gurl.parsed_for_possibly_invalid_spec();
+    SetComponent(url_components, 0, offset,
+                 url::Component(0, static_cast<int>(spec.size())));
+    SetComponent(url_components, 1, offset, parsed.scheme);
+    SetComponent(url_components, 2, offset, parsed.username);
+    SetComponent(url_components, 3, offset, parsed.password);
+    SetComponent(url_components, 4, offset, parsed.host);
+    SetComponent(url_components, 5, offset, parsed.port);
+    SetComponent(url_components, 6, offset, parsed.path);
+    SetComponent(url_components, 7, offset, parsed.query);
+    SetComponent(url_components, 8, offset, parsed.ref);
+  }
+
+  v8::Local<v8::Array> names = v8::Array::New(isolate, kComponentCount);
+  for (size_t i = 0; i < kComponentCount; ++i)
+    names->Set(static_cast<uint32_t>(i),
+               gin::StringToV8(isolate, kComponentNames[i]));
+
+  v8::Local<v8::Value> specs_string = v8::String::NewFromOneByte(isolate,
+      reinterpret_cast<const uint8_t*>(specs.data()),
+      v8::NewStringType::kNormal,
+      static_cast<int>(specs.size())).ToLocalChecked();
+  v8::Local<v8::Value> valid_array =
+      v8::Uint8Array::New(valid_buffer, 0, count);
+  v8::Local<v8::Value> components_array = v8::Int32Array::New(
+      components_buffer, 0, count * kComponentCount * 2);
+
+  gin::Dictionary dict = gin::Dictionary::CreateEmpty(isolate);
+  dict.Set("specs", specs_string);
+  dict.Set("valid", valid_array);
+  dict.Set("components", components_array);
+  dict.Set("componentNames", v8::Local<v8::Value>(names));
+  args.GetReturnValue().Set(gin::ConvertToV8(isolate, dict));
+}
+
 }  // namespace brave
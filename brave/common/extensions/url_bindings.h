@@ -21,6 +21,8 @@ class URLBindings : public extensions::ObjectBackedNativeHandler {
  private:
   void New(const v8::FunctionCallbackInfo<v8::Value>& args);
   void Parse(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void ParseLazy(const v8::FunctionCallbackInfo<v8::Value>& args);
+  void ParseMany(const v8::FunctionCallbackInfo<v8::Value>& args);
   void FormatForDisplay(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   DISALLOW_COPY_AND_ASSIGN(URLBindings);
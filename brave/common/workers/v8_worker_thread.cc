@@ -31,7 +31,8 @@ void NotifyStop(atom::api::App* app, int worker_id) {
   app->Emit("worker-stop", worker_id);
 }
 
-void NotifyError(atom::api::App* app, int worker_id, std::string error) {
+void NotifyLoadError(atom::api::App* app, int worker_id, std::string error) {
+  app->OnWorkerLoadError(worker_id);
   app->Emit("worker-onerror", worker_id, error);
 }
 
@@ -93,11 +94,14 @@ void V8WorkerThread::Run(base::RunLoop* run_loop) {
   base::ThreadRestrictions::SetIOAllowed(true);
   content::WorkerThreadRegistry::Instance()->DidStartCurrentWorkerThread();
   env()->OnMessageLoopCreated();
-  LoadModule();
-  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-      base::Bind(&NotifyStart,
-                  base::Unretained(app()),
-                  GetThreadId()));
+  if (LoadModule()) {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&NotifyStart,
+                    base::Unretained(app()),
+                    GetThreadId()));
+  } else {
+    run_loop->Quit();
+  }
   Thread::Run(run_loop);
 }
 
@@ -115,19 +119,19 @@ void V8WorkerThread::OnMemoryPressure(
   env()->isolate()->LowMemoryNotification();
 }
 
-void V8WorkerThread::LoadModule() {
+bool V8WorkerThread::LoadModule() {
   if (!env()->source_map().Contains(module_name_)) {
     BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-        base::Bind(&NotifyError,
+        base::Bind(&NotifyLoadError,
                     base::Unretained(app()),
                     GetThreadId(),
                     "No source for require(" + module_name_ + ")"));
-    base::RunLoop::QuitCurrentDeprecated();
-    return;
+    return false;
   }
 
   ModuleSystem::NativesEnabledScope natives_enabled(env()->module_system());
   env()->module_system()->Require(module_name_);
+  return true;
 }
 
 }  // namespace brave
@@ -38,7 +38,8 @@ class V8WorkerThread : public base::Thread {
   const std::string& module_name() const { return module_name_; }
 
  private:
-  void LoadModule();
+  // Returns false if the module has no source, the worker then stops.
+  bool LoadModule();
   void OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
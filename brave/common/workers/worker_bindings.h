@@ -5,8 +5,8 @@
 #ifndef BRAVE_COMMON_WORKERS_WORKER_BINDINGS_H_
 #define BRAVE_COMMON_WORKERS_WORKER_BINDINGS_H_
 
+#include <memory>
 #include <string>
-#include <utility>
 
 #include "base/compiler_specific.h"
 #include "base/macros.h"
@@ -17,18 +17,25 @@
 namespace brave {
 
 class V8WorkerThread;
+class WorkerMessage;
 
 class WorkerBindings : public extensions::ObjectBackedNativeHandler {
  public:
   WorkerBindings(extensions::ScriptContext* context, V8WorkerThread* worker);
   ~WorkerBindings() override;
+  // Sends |message| to the worker on |thread_id|, moving the ArrayBuffers in
+  // |transfer_list|. Returns false and sets |error| if it can't be sent.
   static bool OnMessage(v8::Isolate* isolate,
                         base::PlatformThreadId thread_id,
-                        v8::Local<v8::Value> message);
+                        v8::Local<v8::Value> message,
+                        v8::Local<v8::Value> transfer_list,
+                        std::string* error);
+  // Calls the onmessage handler of the current worker with |message|.
+  static void DeliverMessage(std::unique_ptr<WorkerMessage> message);
 
  private:
   void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
-  void PostMessageOnUIThread(const std::pair<uint8_t*, size_t>& buffer);
+  void PostMessageOnUIThread(std::unique_ptr<WorkerMessage> message);
   void PostMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
   void OnErrorOnUIThread(const std::string& message, const std::string& stack);
   void OnError(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -0,0 +1,228 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/worker_message.h"
+
+#include <algorithm>
+
+#include "gin/array_buffer.h"
+
+namespace brave {
+
+namespace {
+
+v8::Local<v8::Private> GetSharedBufferKey(v8::Isolate* isolate) {
+  return v8::Private::ForApi(isolate,
+      v8::String::NewFromUtf8(isolate, "brave::WorkerMessage::SharedBuffer",
+          v8::NewStringType::kNormal).ToLocalChecked());
+}
+
+// Keeps the backing store of a SharedArrayBuffer alive until the object is
+// garbage collected.
+class SharedBufferHandle {
+ public:
+  SharedBufferHandle(v8::Isolate* isolate,
+                     v8::Local<v8::SharedArrayBuffer> object,
+                     WorkerMessage::SharedBuffer* buffer)
+      : object_(isolate, object), buffer_(buffer) {
+    object_.SetWeak(this, &SharedBufferHandle::OnGarbageCollected,
+                    v8::WeakCallbackType::kParameter);
+  }
+
+  WorkerMessage::SharedBuffer* buffer() const { return buffer_.get(); }
+
+ private:
+  static void OnGarbageCollected(
+      const v8::WeakCallbackInfo<SharedBufferHandle>& data) {
+    SharedBufferHandle* handle = data.GetParameter();
+    handle->object_.Reset();
+    delete handle;
+  }
+
+  v8::Global<v8::SharedArrayBuffer> object_;
+  scoped_refptr<WorkerMessage::SharedBuffer> buffer_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedBufferHandle);
+};
+
+void AttachSharedBuffer(v8::Isolate* isolate,
+                        v8::Local<v8::SharedArrayBuffer> object,
+                        WorkerMessage::SharedBuffer* buffer) {
+  SharedBufferHandle* handle = new SharedBufferHandle(isolate, object, buffer);
+  object->SetPrivate(isolate->GetCurrentContext(), GetSharedBufferKey(isolate),
+                     v8::External::New(isolate, handle));
+}
+
+// Returns the SharedBuffer backing |object|, externalizing it on first use.
+scoped_refptr<WorkerMessage::SharedBuffer> GetSharedBuffer(
+    v8::Isolate* isolate, v8::Local<v8::SharedArrayBuffer> object) {
+  if (object->IsExternal()) {
+    // Only buffers externalized by us can be shared, the others are owned by
+    // somebody who doesn't know about the other isolates.
+    v8::Local<v8::Value> value;
+    if (!object->GetPrivate(isolate->GetCurrentContext(),
+                            GetSharedBufferKey(isolate)).ToLocal(&value) ||
+        !value->IsExternal())
+      return nullptr;
+    return static_cast<SharedBufferHandle*>(
+        value.As<v8::External>()->Value())->buffer();
+  }
+
+  v8::SharedArrayBuffer::Contents contents = object->Externalize();
+  scoped_refptr<WorkerMessage::SharedBuffer> buffer(
+      new WorkerMessage::SharedBuffer(contents.Data(), contents.ByteLength()));
+  AttachSharedBuffer(isolate, object, buffer.get());
+  return buffer;
+}
+
+}  // namespace
+
+class WorkerMessage::SerializerDelegate
+    : public v8::ValueSerializer::Delegate {
+ public:
+  SerializerDelegate(WorkerMessage* message, v8::Isolate* isolate)
+      : message_(message), isolate_(isolate) {}
+
+  void ThrowDataCloneError(v8::Local<v8::String> message) override {
+    isolate_->ThrowException(v8::Exception::Error(message));
+  }
+
+  v8::Maybe<uint32_t> GetSharedArrayBufferId(
+      v8::Isolate* isolate,
+      v8::Local<v8::SharedArrayBuffer> object) override {
+    for (size_t i = 0; i < objects_.size(); ++i) {
+      if (objects_[i] == object)
+        return v8::Just(static_cast<uint32_t>(i));
+    }
+
+    scoped_refptr<SharedBuffer> buffer = GetSharedBuffer(isolate, object);
+    if (!buffer) {
+      ThrowDataCloneError(v8::String::NewFromUtf8(isolate,
+          "SharedArrayBuffer can not be shared",
+          v8::NewStringType::kNormal).ToLocalChecked());
+      return v8::Nothing<uint32_t>();
+    }
+    objects_.push_back(object);
+    message_->shared_buffers_.push_back(buffer);
+    return v8::Just(static_cast<uint32_t>(objects_.size() - 1));
+  }
+
+ private:
+  WorkerMessage* message_;
+  v8::Isolate* isolate_;
+  std::vector<v8::Local<v8::SharedArrayBuffer>> objects_;
+
+  DISALLOW_COPY_AND_ASSIGN(SerializerDelegate);
+};
+
+WorkerMessage::SharedBuffer::SharedBuffer(void* data, size_t length)
+    : data_(data), length_(length) {
+}
+
+WorkerMessage::SharedBuffer::~SharedBuffer() {
+  gin::ArrayBufferAllocator::SharedInstance()->Free(data_, length_);
+}
+
+WorkerMessage::WorkerMessage() : size_(0) {
+}
+
+WorkerMessage::~WorkerMessage() {
+  // Free the transferred buffers that never reached the other isolate.
+  for (const auto& contents : array_buffers_)
+    gin::ArrayBufferAllocator::SharedInstance()->Free(contents.Data(),
+                                                      contents.ByteLength());
+}
+
+bool WorkerMessage::Serialize(v8::Isolate* isolate,
+                              v8::Local<v8::Value> value,
+                              v8::Local<v8::Value> transfer_list,
+                              std::string* error) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+
+  std::vector<v8::Local<v8::ArrayBuffer>> transfers;
+  if (!transfer_list.IsEmpty() && !transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      *error = "`transferList` must be an Array";
+      return false;
+    }
+    v8::Local<v8::Array> array = transfer_list.As<v8::Array>();
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+      v8::Local<v8::Value> item;
+      if (!array->Get(context, i).ToLocal(&item) || !item->IsArrayBuffer()) {
+        *error = "`transferList` can only contain ArrayBuffers";
+        return false;
+      }
+      v8::Local<v8::ArrayBuffer> buffer = item.As<v8::ArrayBuffer>();
+      if (std::find(transfers.begin(), transfers.end(), buffer) !=
+          transfers.end()) {
+        *error = "ArrayBuffer is listed more than once in `transferList`";
+        return false;
+      }
+      // External buffers are owned by somebody else, so their memory can't
+      // be handed over.
+      if (buffer->IsExternal() || !buffer->IsNeuterable()) {
+        *error = "ArrayBuffer in `transferList` can not be transferred";
+        return false;
+      }
+      transfers.push_back(buffer);
+    }
+  }
+
+  SerializerDelegate delegate(this, isolate);
+  v8::ValueSerializer serializer(isolate, &delegate);
+  for (size_t i = 0; i < transfers.size(); ++i)
+    serializer.TransferArrayBuffer(static_cast<uint32_t>(i), transfers[i]);
+
+  v8::TryCatch try_catch(isolate);
+  serializer.WriteHeader();
+  if (!serializer.WriteValue(context, value).FromMaybe(false)) {
+    *error = "`postMessage` could not serialize message";
+    if (try_catch.HasCaught() && !try_catch.Message().IsEmpty())
+      *error = *v8::String::Utf8Value(try_catch.Message()->Get());
+    shared_buffers_.clear();
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  data_.reset(buffer.first);
+  size_ = buffer.second;
+
+  // Take the memory away from the sending isolate.
+  for (const auto& transfer : transfers) {
+    array_buffers_.push_back(transfer->Externalize());
+    transfer->Neuter();
+  }
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> WorkerMessage::Deserialize(v8::Isolate* isolate) {
+  v8::Local<v8::Context> context = isolate->GetCurrentContext();
+  v8::ValueDeserializer deserializer(isolate, data_.get(), size_);
+  deserializer.SetSupportsLegacyWireFormat(true);
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+
+  // All isolates allocate ArrayBuffers with the same allocator, so the new
+  // isolate can take ownership of the memory.
+  for (size_t i = 0; i < array_buffers_.size(); ++i) {
+    deserializer.TransferArrayBuffer(static_cast<uint32_t>(i),
+        v8::ArrayBuffer::New(isolate, array_buffers_[i].Data(),
+                             array_buffers_[i].ByteLength(),
+                             v8::ArrayBufferCreationMode::kInternalized));
+  }
+  array_buffers_.clear();
+
+  for (size_t i = 0; i < shared_buffers_.size(); ++i) {
+    v8::Local<v8::SharedArrayBuffer> object = v8::SharedArrayBuffer::New(
+        isolate, shared_buffers_[i]->data(), shared_buffers_[i]->length(),
+        v8::ArrayBufferCreationMode::kExternalized);
+    AttachSharedBuffer(isolate, object, shared_buffers_[i].get());
+    deserializer.TransferSharedArrayBuffer(static_cast<uint32_t>(i), object);
+  }
+  shared_buffers_.clear();
+
+  return deserializer.ReadValue(context);
+}
+
+}  // namespace brave
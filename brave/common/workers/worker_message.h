@@ -0,0 +1,75 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+#define BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/free_deleter.h"
+#include "base/memory/ref_counted.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// A message serialized in one isolate and deserialized in another one.
+//
+// ArrayBuffers in the transfer list are not copied, their backing stores are
+// detached from the sending isolate and handed over to the receiving one.
+// SharedArrayBuffers are shared by both isolates, the memory is released when
+// no isolate references it anymore.
+class WorkerMessage {
+ public:
+  // Backing store of a SharedArrayBuffer used by more than one isolate.
+  class SharedBuffer : public base::RefCountedThreadSafe<SharedBuffer> {
+   public:
+    SharedBuffer(void* data, size_t length);
+
+    void* data() const { return data_; }
+    size_t length() const { return length_; }
+
+   private:
+    friend class base::RefCountedThreadSafe<SharedBuffer>;
+    ~SharedBuffer();
+
+    void* data_;
+    size_t length_;
+
+    DISALLOW_COPY_AND_ASSIGN(SharedBuffer);
+  };
+
+  WorkerMessage();
+  ~WorkerMessage();
+
+  // Serializes |value| and moves the ArrayBuffers in |transfer_list|, which
+  // can be empty or undefined. Returns false and sets |error| on failure.
+  bool Serialize(v8::Isolate* isolate,
+                 v8::Local<v8::Value> value,
+                 v8::Local<v8::Value> transfer_list,
+                 std::string* error);
+
+  // Recreates the message in |isolate|, can only be called once.
+  v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate);
+
+ private:
+  class SerializerDelegate;
+
+  std::unique_ptr<uint8_t, base::FreeDeleter> data_;
+  size_t size_;
+
+  // Transferred backing stores, owned until the message is deserialized.
+  std::vector<v8::ArrayBuffer::Contents> array_buffers_;
+  std::vector<scoped_refptr<SharedBuffer>> shared_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerMessage);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
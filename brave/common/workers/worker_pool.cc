@@ -0,0 +1,222 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/worker_pool.h"
+
+#include <utility>
+
+#include "base/bind.h"
+#include "brave/common/workers/v8_worker_thread.h"
+#include "brave/common/workers/worker_bindings.h"
+#include "brave/common/workers/worker_message.h"
+
+namespace brave {
+
+WorkerPool::Stats::Stats()
+    : workers(0),
+      idle_workers(0),
+      queue_depth(0),
+      completed(0),
+      stolen(0) {
+}
+
+WorkerPool::Task::Task() {
+}
+
+WorkerPool::Task::Task(Task&& other) = default;
+
+WorkerPool::Task::~Task() {
+}
+
+WorkerPool::Task& WorkerPool::Task::operator=(Task&& other) = default;
+
+WorkerPool::Worker::Worker() : id(0), scheduled(false), removed(false) {
+}
+
+WorkerPool::Worker::~Worker() {
+}
+
+WorkerPool::WorkerPool(const std::string& module_name, atom::api::App* app)
+    : module_name_(module_name),
+      app_(app),
+      completed_(0),
+      stolen_(0) {
+}
+
+WorkerPool::~WorkerPool() {
+}
+
+std::vector<int> WorkerPool::Start(size_t size) {
+  std::vector<int> ids;
+  base::AutoLock auto_lock(lock_);
+  for (size_t i = 0; i < size; ++i) {
+    // The thread deletes itself when it is shut down.
+    auto thread = new V8WorkerThread(module_name_ + "_worker", module_name_,
+                                     app_);
+    if (!thread->Start()) {
+      delete thread;
+      continue;
+    }
+    ids.push_back(thread->GetThreadId());
+
+    std::unique_ptr<Worker> worker(new Worker);
+    worker->id = thread->GetThreadId();
+    worker->task_runner = thread->task_runner();
+    workers_.push_back(std::move(worker));
+  }
+  return ids;
+}
+
+void WorkerPool::PostMessage(std::unique_ptr<WorkerMessage> message) {
+  Task task;
+  task.message = std::move(message);
+  task.posted = base::TimeTicks::Now();
+
+  base::AutoLock auto_lock(lock_);
+  QueueTaskLocked(std::move(task));
+}
+
+void WorkerPool::RemoveWorker(int worker_id) {
+  base::AutoLock auto_lock(lock_);
+  for (const auto& worker : workers_) {
+    if (worker->id != worker_id || worker->removed)
+      continue;
+    worker->removed = true;
+    std::deque<Task> queue;
+    queue.swap(worker->queue);
+    for (auto& task : queue) {
+      if (!QueueTaskLocked(std::move(task)))
+        break;
+    }
+    return;
+  }
+}
+
+void WorkerPool::Shutdown() {
+  base::AutoLock auto_lock(lock_);
+  for (const auto& worker : workers_) {
+    worker->queue.clear();
+    worker->task_runner->PostTask(FROM_HERE,
+        base::Bind(&V8WorkerThread::Shutdown));
+  }
+  workers_.clear();
+}
+
+WorkerPool::Stats WorkerPool::GetStats() {
+  Stats stats;
+  base::AutoLock auto_lock(lock_);
+  for (const auto& worker : workers_) {
+    if (worker->removed)
+      continue;
+    ++stats.workers;
+    if (!worker->scheduled)
+      ++stats.idle_workers;
+    stats.queue_depth += worker->queue.size();
+  }
+  stats.completed = completed_;
+  stats.stolen = stolen_;
+  stats.max_wait = max_wait_;
+  if (completed_) {
+    stats.average_wait = total_wait_ / completed_;
+    stats.average_run = total_run_ / completed_;
+  }
+  return stats;
+}
+
+void WorkerPool::RunTask(size_t index) {
+  Task task;
+  {
+    base::AutoLock auto_lock(lock_);
+    if (index >= workers_.size())
+      return;
+    if (workers_[index]->removed || !TakeTaskLocked(index, &task)) {
+      workers_[index]->scheduled = false;
+      return;
+    }
+  }
+
+  base::TimeTicks start = base::TimeTicks::Now();
+  WorkerBindings::DeliverMessage(std::move(task.message));
+  base::TimeTicks end = base::TimeTicks::Now();
+
+  base::AutoLock auto_lock(lock_);
+  ++completed_;
+  total_wait_ += start - task.posted;
+  if (start - task.posted > max_wait_)
+    max_wait_ = start - task.posted;
+  total_run_ += end - start;
+
+  // Go back to the message loop between messages, so timers and shutdown
+  // requests of the worker aren't starved.
+  if (index < workers_.size()) {
+    workers_[index]->scheduled = false;
+    ScheduleLocked(index);
+  }
+}
+
+bool WorkerPool::QueueTaskLocked(Task task) {
+  lock_.AssertAcquired();
+
+  // Prefer an idle worker, then the shortest queue.
+  size_t index = workers_.size();
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    if (workers_[i]->removed)
+      continue;
+    if (!workers_[i]->scheduled) {
+      index = i;
+      break;
+    }
+    if (index == workers_.size() ||
+        workers_[i]->queue.size() < workers_[index]->queue.size())
+      index = i;
+  }
+  if (index == workers_.size())
+    return false;
+
+  workers_[index]->queue.push_back(std::move(task));
+  ScheduleLocked(index);
+  return true;
+}
+
+bool WorkerPool::TakeTaskLocked(size_t index, Task* task) {
+  lock_.AssertAcquired();
+
+  std::deque<Task>& own = workers_[index]->queue;
+  if (!own.empty()) {
+    *task = std::move(own.front());
+    own.pop_front();
+    return true;
+  }
+
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    std::deque<Task>& other = workers_[(index + i) % workers_.size()]->queue;
+    if (!other.empty()) {
+      *task = std::move(other.back());
+      other.pop_back();
+      ++stolen_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkerPool::ScheduleLocked(size_t index) {
+  lock_.AssertAcquired();
+
+  Worker* worker = workers_[index].get();
+  if (worker->scheduled || worker->removed)
+    return;
+  // Only keep the worker running if there is something to do, an idle worker
+  // will pick up new messages when they are posted.
+  bool has_work = false;
+  for (const auto& other : workers_)
+    has_work |= !other->queue.empty();
+  if (!has_work)
+    return;
+
+  worker->scheduled = worker->task_runner->PostTask(FROM_HERE,
+      base::Bind(&WorkerPool::RunTask, this, index));
+}
+
+}  // namespace brave
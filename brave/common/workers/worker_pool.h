@@ -0,0 +1,127 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_WORKER_POOL_H_
+#define BRAVE_COMMON_WORKERS_WORKER_POOL_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/single_thread_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace atom {
+namespace api {
+class App;
+}
+}
+
+namespace brave {
+
+class WorkerMessage;
+
+// A fixed number of V8WorkerThreads running the same module, which stay alive
+// between messages so the isolate and module are only set up once.
+//
+// Every worker has its own queue. A message goes to an idle worker when
+// there is one and to the shortest queue otherwise, and workers that run out
+// of messages steal from the back of the other queues.
+class WorkerPool : public base::RefCountedThreadSafe<WorkerPool> {
+ public:
+  struct Stats {
+    Stats();
+
+    size_t workers;
+    size_t idle_workers;
+    size_t queue_depth;
+    uint64_t completed;
+    uint64_t stolen;
+    // Time between posting and running a message.
+    base::TimeDelta average_wait;
+    base::TimeDelta max_wait;
+    // Time spent in the onmessage handler.
+    base::TimeDelta average_run;
+  };
+
+  WorkerPool(const std::string& module_name, atom::api::App* app);
+
+  // Starts |size| workers and returns their ids, which are the ids used by
+  // the worker-* events of the app.
+  std::vector<int> Start(size_t size);
+
+  // Queues |message| for one of the workers, can be called on any thread.
+  void PostMessage(std::unique_ptr<WorkerMessage> message);
+
+  // Stops handing messages to the worker with id |worker_id|, whose module
+  // failed to load. Its queued messages are moved to the other workers.
+  void RemoveWorker(int worker_id);
+
+  // Stops all workers, queued messages are dropped.
+  void Shutdown();
+
+  Stats GetStats();
+
+ private:
+  friend class base::RefCountedThreadSafe<WorkerPool>;
+
+  struct Task {
+    Task();
+    Task(Task&& other);
+    ~Task();
+    Task& operator=(Task&& other);
+
+    std::unique_ptr<WorkerMessage> message;
+    base::TimeTicks posted;
+  };
+
+  struct Worker {
+    Worker();
+    ~Worker();
+
+    int id;
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner;
+    std::deque<Task> queue;
+    // A RunTask is pending or running on the worker.
+    bool scheduled;
+    // Removed from the pool, the worker keeps its index but gets no messages.
+    bool removed;
+  };
+
+  ~WorkerPool();
+
+  // Runs one message on worker |index|, called on its thread.
+  void RunTask(size_t index);
+
+  // Queues |task| for an idle worker, or the one with the shortest queue.
+  // Returns false if no worker is left. |lock_| must be held.
+  bool QueueTaskLocked(Task task);
+  // Pops the next message for worker |index|, stealing from the others when
+  // its own queue is empty. |lock_| must be held.
+  bool TakeTaskLocked(size_t index, Task* task);
+  void ScheduleLocked(size_t index);
+
+  const std::string module_name_;
+  atom::api::App* app_;
+
+  base::Lock lock_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  uint64_t completed_;
+  uint64_t stolen_;
+  base::TimeDelta total_wait_;
+  base::TimeDelta max_wait_;
+  base::TimeDelta total_run_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_WORKER_POOL_H_
@@ -6,8 +6,12 @@
 
 #include "brave/utility/importer/brave_external_process_importer_bridge.h"
 
+#include "base/bind.h"
 #include "base/logging.h"
+#include "base/single_thread_task_runner.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "build/build_config.h"
+#include "chrome/common/importer/importer_url_row.h"
 
 using chrome::mojom::ProfileImportObserver;
 
@@ -15,11 +19,14 @@ namespace {
 
 const int kNumCookiesToSend = 100;
 
+// Pages the importer may queue before the observer's thread has sent them.
+const int kMaxPagesInFlight = 4;
+
 }  // namespace
 
 void BraveExternalProcessImporterBridge::SetCookies(
     const std::vector<ImportedCookieEntry>& cookies) {
-  (*observer_)->OnCookiesImportStart(cookies.size());
+  StartCookies(cookies.size());
 
   // |cookies_left| is required for the checks below as Windows has a
   // Debug bounds-check which prevents pushing an iterator beyond its end()
@@ -32,16 +39,76 @@ void BraveExternalProcessImporterBridge::SetCookies(
         it + std::min(cookies_left, kNumCookiesToSend);
     cookies_group.assign(it, end_group);
 
-    (*observer_)->OnCookiesImportGroup(cookies_group);
+    AddCookies(cookies_group);
     cookies_left -= end_group - it;
     it = end_group;
   }
   DCHECK_EQ(0, cookies_left);
 }
 
+void BraveExternalProcessImporterBridge::StartHistoryItems(
+    size_t total_count) {
+  (*observer_)->OnHistoryImportStart(static_cast<uint32_t>(total_count));
+}
+
+void BraveExternalProcessImporterBridge::AddHistoryItems(
+    const std::vector<ImporterURLRow>& rows,
+    importer::VisitSource visit_source) {
+  if (!WaitToSendPage())
+    return;
+  (*observer_)->OnHistoryImportGroup(rows, visit_source);
+  PageQueued();
+}
+
+void BraveExternalProcessImporterBridge::StartCookies(size_t total_count) {
+  (*observer_)->OnCookiesImportStart(static_cast<uint32_t>(total_count));
+}
+
+void BraveExternalProcessImporterBridge::AddCookies(
+    const std::vector<ImportedCookieEntry>& cookies) {
+  if (!WaitToSendPage())
+    return;
+  (*observer_)->OnCookiesImportGroup(cookies);
+  PageQueued();
+}
+
+void BraveExternalProcessImporterBridge::Cancel() {
+  base::AutoLock auto_lock(lock_);
+  cancelled_ = true;
+  page_sent_.Signal();
+}
+
+bool BraveExternalProcessImporterBridge::WaitToSendPage() {
+  base::AutoLock auto_lock(lock_);
+  while (pages_in_flight_ >= kMaxPagesInFlight && !cancelled_)
+    page_sent_.Wait();
+  if (cancelled_)
+    return false;
+  ++pages_in_flight_;
+  return true;
+}
+
+void BraveExternalProcessImporterBridge::PageQueued() {
+  // |observer_| forwards calls made on other threads through the task runner
+  // of its thread, so this runs once the page has been written to the pipe.
+  observer_task_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&BraveExternalProcessImporterBridge::OnPageSent, this));
+}
+
+void BraveExternalProcessImporterBridge::OnPageSent() {
+  base::AutoLock auto_lock(lock_);
+  --pages_in_flight_;
+  page_sent_.Signal();
+}
+
 BraveExternalProcessImporterBridge::BraveExternalProcessImporterBridge(
     const base::DictionaryValue& localized_strings,
     scoped_refptr<chrome::mojom::ThreadSafeProfileImportObserverPtr> observer)
-  : ExternalProcessImporterBridge(localized_strings, observer) {}
+  : ExternalProcessImporterBridge(localized_strings, observer),
+    observer_task_runner_(base::ThreadTaskRunnerHandle::Get()),
+    page_sent_(&lock_),
+    pages_in_flight_(0),
+    cancelled_(false) {}
 
 BraveExternalProcessImporterBridge::~BraveExternalProcessImporterBridge() {}
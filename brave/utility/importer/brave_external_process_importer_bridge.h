@@ -7,9 +7,16 @@
 
 #include <vector>
 
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
 #include "chrome/utility/importer/external_process_importer_bridge.h"
 
+namespace base {
+class SingleThreadTaskRunner;
+}
+
 struct ImportedCookieEntry;
+struct ImporterURLRow;
 
 class BraveExternalProcessImporterBridge :
                                       public ExternalProcessImporterBridge {
@@ -21,9 +28,42 @@ class BraveExternalProcessImporterBridge :
           observer);
 
   void SetCookies(const std::vector<ImportedCookieEntry>& cookies);
+
+  // Streaming counterparts of SetHistoryItems and SetCookies for importers
+  // that read their rows in pages. The browser hands every page on as it
+  // arrives, |total_count| is only used to report progress.
+  //
+  // The browser doesn't acknowledge pages, so the pages are only paced up to
+  // the pipe: the importer blocks while a few pages are still waiting for the
+  // observer's thread to send them, which bounds the memory of this process.
+  void StartHistoryItems(size_t total_count);
+  void AddHistoryItems(const std::vector<ImporterURLRow>& rows,
+                       importer::VisitSource visit_source);
+  void StartCookies(size_t total_count);
+  void AddCookies(const std::vector<ImportedCookieEntry>& cookies);
+
+  // Wakes up and drops the pages of an importer waiting to send one. Called
+  // on the observer's thread before the import thread is joined.
+  void Cancel();
+
  private:
   ~BraveExternalProcessImporterBridge() override;
 
+  // Runs on the import thread, returns false if the import was cancelled.
+  bool WaitToSendPage();
+  // Called once a page has been passed to |observer_|.
+  void PageQueued();
+  // Runs on the observer's thread after the page was sent.
+  void OnPageSent();
+
+  const scoped_refptr<base::SingleThreadTaskRunner> observer_task_runner_;
+
+  base::Lock lock_;
+  base::ConditionVariable page_sent_;
+  // Guarded by |lock_|.
+  int pages_in_flight_;
+  bool cancelled_;
+
   DISALLOW_COPY_AND_ASSIGN(BraveExternalProcessImporterBridge);
 };
 
@@ -70,3 +70,10 @@ void BraveProfileImportImpl::StartImport(
                                 source_profile, items,
                                 base::RetainedRef(bridge_)));
 }
+
+void BraveProfileImportImpl::CancelImport() {
+  // The importer may be waiting for this thread to send its pages.
+  if (bridge_)
+    static_cast<BraveExternalProcessImporterBridge*>(bridge_.get())->Cancel();
+  ProfileImportImpl::CancelImport();
+}
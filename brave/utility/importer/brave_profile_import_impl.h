@@ -21,6 +21,7 @@ class BraveProfileImportImpl : public ProfileImportImpl {
                    uint16_t items,
                    std::unique_ptr<base::DictionaryValue> localized_strings,
                    chrome::mojom::ProfileImportObserverPtr observer) override;
+  void CancelImport() override;
 
   DISALLOW_COPY_AND_ASSIGN(BraveProfileImportImpl);
 };
@@ -51,6 +51,14 @@ base::nix::DesktopEnvironment ChromeImporter::GetDesktopEnvironment() {
 }
 #endif
 
+namespace {
+
+// Rows are read and sent to the browser in pages of this size, so a large
+// profile is never held in memory at once.
+const size_t kImportPageSize = 1000;
+
+}  // namespace
+
 ChromeImporter::ChromeImporter() {
 }
 
@@ -104,6 +112,15 @@ void ChromeImporter::ImportHistory() {
   if (!db.Open(history_path))
     return;
 
+  sql::Statement count(db.GetUniqueStatement(
+      "SELECT COUNT(*) FROM urls WHERE hidden = 0"));
+  if (!count.Step())
+    return;
+
+  BraveExternalProcessImporterBridge* bridge =
+      static_cast<BraveExternalProcessImporterBridge*>(bridge_.get());
+  bridge->StartHistoryItems(count.ColumnInt(0));
+
   const char query[] =
     "SELECT url, title, last_visit_time, typed_count, visit_count "
     "FROM urls WHERE hidden = 0";
@@ -111,6 +128,7 @@ void ChromeImporter::ImportHistory() {
   sql::Statement s(db.GetUniqueStatement(query));
 
   std::vector<ImporterURLRow> rows;
+  rows.reserve(kImportPageSize);
   while (s.Step() && !cancelled()) {
     GURL url(s.ColumnString(0));
 
@@ -123,10 +141,14 @@ void ChromeImporter::ImportHistory() {
     row.visit_count = s.ColumnInt(4);
 
     rows.push_back(row);
+    if (rows.size() == kImportPageSize) {
+      bridge->AddHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+      rows.clear();
+    }
   }
 
   if (!rows.empty() && !cancelled())
-    bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+    bridge->AddHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
 }
 
 void ChromeImporter::ImportBookmarks() {
@@ -256,13 +278,25 @@ void ChromeImporter::ImportCookies() {
   if (!db.Open(cookies_path))
     return;
 
+  // Rows whose value fails to decrypt are only known once they are read, the
+  // browser corrects the total when the item ends.
+  sql::Statement count(db.GetUniqueStatement(
+      "SELECT COUNT(*) FROM cookies WHERE host_key != ''"));
+  if (!count.Step())
+    return;
+
+  BraveExternalProcessImporterBridge* bridge =
+      static_cast<BraveExternalProcessImporterBridge*>(bridge_.get());
+  bridge->StartCookies(count.ColumnInt(0));
+
   const char query[] =
     "SELECT host_key, name, value, path, expires_utc, secure, httponly, "
-    "encrypted_value FROM cookies";
+    "encrypted_value FROM cookies WHERE host_key != ''";
 
   sql::Statement s(db.GetUniqueStatement(query));
 
   std::vector<ImportedCookieEntry> cookies;
+  cookies.reserve(kImportPageSize);
   while (s.Step() && !cancelled()) {
     ImportedCookieEntry cookie;
     base::string16 host;
@@ -301,11 +335,14 @@ void ChromeImporter::ImportCookies() {
     }
 
     cookies.push_back(cookie);
+    if (cookies.size() == kImportPageSize) {
+      bridge->AddCookies(cookies);
+      cookies.clear();
+    }
   }
 
   if (!cookies.empty() && !cancelled())
-    static_cast<BraveExternalProcessImporterBridge*>(bridge_.get())->
-        SetCookies(cookies);
+    bridge->AddCookies(cookies);
 }
 
 void ChromeImporter::ImportPasswords() {
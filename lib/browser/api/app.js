@@ -71,9 +71,9 @@ Worker.prototype.start = function (cb) {
   this.id = app._startWorker(this.module_name)
 }
 
-Worker.prototype.postMessage = function (message) {
+Worker.prototype.postMessage = function (message, transferList) {
   const evt = {data: message}
-  app._postMessage(this.id, evt)
+  app._postMessage(this.id, evt, transferList)
 }
 
 Worker.prototype.terminate = function () {
@@ -125,6 +125,69 @@ app.createWorker = function (module_name) {
   return worker
 }
 
+function WorkerPool (module_name, size) {
+  this.module_name = module_name
+  this.size = size
+  this.workerIds = []
+  this.onmessage = null
+  this.onerror = null
+  this._listeners = null
+}
+
+WorkerPool.prototype.start = function () {
+  this.workerIds = app._startWorkerPool(this.module_name, this.size)
+
+  // Pool workers emit the same worker-* events as other workers. The
+  // listeners are only added once the pool is running, so a pool that failed
+  // to start leaves nothing behind.
+  this._listeners = {
+    'worker-post-message': (e, worker_id, message) => {
+      if (this.workerIds.includes(worker_id)) {
+        const event = {data: message, workerId: worker_id}
+        this.emit('message', event)
+        this.onmessage && this.onmessage(event)
+      }
+    },
+    'worker-onerror': (e, worker_id, message, stack) => {
+      if (this.workerIds.includes(worker_id)) {
+        this.onerror && this.onerror(message, stack, worker_id)
+      }
+    }
+  }
+  for (const name in this._listeners) {
+    app.on(name, this._listeners[name])
+  }
+}
+
+// The message is handled by the first idle worker of the pool.
+WorkerPool.prototype.postMessage = function (message, transferList) {
+  const evt = {data: message}
+  app._postPoolMessage(this.module_name, evt, transferList)
+}
+
+WorkerPool.prototype.getStats = function () {
+  return app._getWorkerPoolStats(this.module_name)
+}
+
+WorkerPool.prototype.terminate = function () {
+  if (this._listeners) {
+    for (const name in this._listeners) {
+      app.removeListener(name, this._listeners[name])
+    }
+    this._listeners = null
+  }
+  this.workerIds = []
+  app._stopWorkerPool(this.module_name)
+}
+
+Object.setPrototypeOf(WorkerPool.prototype, EventEmitter.prototype)
+
+app.createWorkerPool = function (module_name, size) {
+  const pool = new WorkerPool(module_name, size)
+  pool.start()
+  return pool
+}
+
 app.allowNTLMCredentialsForAllDomains = function (allow) {
   if (!process.noDeprecations) {
     deprecate.warn('app.allowNTLMCredentialsForAllDomains', 'session.allowNTLMCredentialsForDomains')
@@ -188,6 +188,15 @@ WebContents.prototype._init = function () {
     })
     ipcMain.emit(channel, event, ...args)
   })
+  this.on('ipc-message-sync-serialized', function (event, [channel, ...args]) {
+    Object.defineProperty(event, 'returnValue', {
+      set: function (value) {
+        return event.sendSerializedReply(value)
+      },
+      get: function () {}
+    })
+    ipcMain.emit(channel, event, ...args)
+  })
 
   // Handle context menu action request from pepper plugin.
   this.on('pepper-context-menu', function (event, params) {
@@ -235,6 +244,10 @@ module.exports = {
     return binding.fromTabID(tabID)
   },
 
+  getTabsById (tabIDs) {
+    return binding.fromTabIDs(tabIDs)
+  },
+
   getFocusedWebContents () {
     let focused = null
     for (let contents of binding.getAllWebContents()) {
@@ -42,12 +42,28 @@ let getObjectMembers = function (object) {
   })
 }
 
+// The members of prototypes, which are shared by all the objects of a
+// constructor. They are described again when the own property names of the
+// prototype change, so members added after it was first sent show up.
+// prototype => {names, members}
+const prototypeMembers = new WeakMap()
+
+const sameNames = function (a, b) {
+  return a.length === b.length && a.every((name, i) => name === b[i])
+}
+
 // Return the description of object's prototype.
 let getObjectPrototype = function (object) {
   let proto = Object.getPrototypeOf(object)
   if (proto === null || proto === Object.prototype) return null
+  const names = Object.getOwnPropertyNames(proto)
+  let cached = prototypeMembers.get(proto)
+  if (!cached || !sameNames(cached.names, names)) {
+    cached = {names, members: getObjectMembers(proto)}
+    prototypeMembers.set(proto, cached)
+  }
   return {
-    members: getObjectMembers(proto),
+    members: cached.members,
     proto: getObjectPrototype(proto)
   }
 }
@@ -346,6 +362,60 @@ ipcMain.on('ELECTRON_BROWSER_MEMBER_GET', function (event, id, name) {
   }
 })
 
+// Run one operation of a batch, |values| are the results of the previous ones.
+const runBatchOperation = function (sender, values, operation) {
+  let target
+  if (operation.target.type === 'result') {
+    if (!(operation.target.index < values.length)) {
+      throw new Error(`Invalid batch result reference ${operation.target.index}`)
+    }
+    target = values[operation.target.index]
+  } else {
+    target = objectsRegistry.get(operation.target.id)
+  }
+
+  switch (operation.type) {
+    case 'get':
+      return target[operation.name]
+    case 'set':
+      target[operation.name] = unwrapArgs(sender, [operation.value])[0]
+      return undefined
+    case 'call': {
+      const func = operation.name == null ? target : target[operation.name]
+      const caller = operation.name == null ? global : target
+      if (v8Util.getHiddenValue(func, 'asynchronous')) {
+        throw new Error('Asynchronous functions can not be called in a batch')
+      }
+      return func.apply(caller, unwrapArgs(sender, operation.args))
+    }
+    default:
+      throw new TypeError(`Unknown batch operation: ${operation.type}`)
+  }
+}
+
+// Run a list of operations in one round trip, stopping at the first one that
+// throws. The reply is serialized with the structured clone algorithm.
+ipcMain.on('ELECTRON_BROWSER_BATCH', function (event, operations) {
+  const values = []
+  const results = []
+  try {
+    for (const operation of operations) {
+      const value = runBatchOperation(event.sender, values, operation)
+      values.push(value)
+      results.push(valueToMeta(event.sender, value, operation.type === 'call'))
+    }
+  } catch (error) {
+    results.push(exceptionToMeta(error))
+  }
+
+  try {
+    event.returnValue = results
+  } catch (error) {
+    // A value couldn't be serialized.
+    event.returnValue = [exceptionToMeta(error)]
+  }
+})
+
 ipcMain.on('ELECTRON_BROWSER_DEREFERENCE', function (event, id) {
   objectsRegistry.remove(event.sender.getId(), id)
 })
@@ -232,6 +232,25 @@
       fs.writeSync(logFDs[asarPath], offset + ': ' + filePath + '\n')
     }
 
+    // Read the bytes of a packed file, inflating compressed entries.
+    const readPackedFileSync = function (fd, info) {
+      const storedSize = info.encoding ? info.compressedSize : info.size
+      const buffer = new Buffer(storedSize)
+      fs.readSync(fd, buffer, 0, storedSize, info.offset)
+      return info.encoding ? require('zlib').gunzipSync(buffer) : buffer
+    }
+
+    const readPackedFile = function (fd, info, callback) {
+      const storedSize = info.encoding ? info.compressedSize : info.size
+      const buffer = new Buffer(storedSize)
+      fs.read(fd, buffer, 0, storedSize, info.offset, function (error) {
+        if (error || !info.encoding) {
+          return callback(error, buffer)
+        }
+        require('zlib').gunzip(buffer, callback)
+      })
+    }
+
     const {lstatSync} = fs
     fs.lstatSync = function (p) {
       const [isAsar, asarPath, filePath] = splitPath(p)
@@ -483,14 +502,16 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
         return notFoundError(asarPath, filePath, callback)
       }
       logASARAccess(asarPath, filePath, info.offset)
-      fs.read(fd, buffer, 0, info.size, info.offset, function (error) {
-        callback(error, encoding ? buffer.toString(encoding) : buffer)
+      readPackedFile(fd, info, function (error, buffer) {
+        if (error) {
+          return callback(error)
+        }
+        callback(null, encoding ? buffer.toString(encoding) : buffer)
       })
     }
 
@@ -531,13 +552,12 @@
         throw new TypeError('Bad arguments')
       }
       const {encoding} = options
-      const buffer = new Buffer(info.size)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
         notFoundError(asarPath, filePath)
       }
       logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
+      const buffer = readPackedFileSync(fd, info)
       if (encoding) {
         return buffer.toString(encoding)
       } else {
@@ -604,14 +624,12 @@
           encoding: 'utf8'
         })
       }
-      const buffer = new Buffer(info.size)
       const fd = archive.getFd()
       if (!(fd >= 0)) {
         return
       }
       logASARAccess(asarPath, filePath, info.offset)
-      fs.readSync(fd, buffer, 0, info.size, info.offset)
-      return buffer.toString('utf8')
+      return readPackedFileSync(fd, info).toString('utf8')
     }
 
     const {internalModuleStat} = process.binding('fs')
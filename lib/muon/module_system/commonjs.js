@@ -1,6 +1,7 @@
 const path = requireNative('path')
+const moduleLoader = requireNative('moduleLoader')
 
-const commonjs = function (fn, exports, modulePath, __global__) {
+const commonjs = function (fn, exports, modulePath, __global__, natives) {
   // convert module.exports to exports.$set
   const exportsHandler = {
     set: (target, name, value) => {
@@ -66,7 +67,7 @@ const commonjs = function (fn, exports, modulePath, __global__) {
     }
 
     try {
-      fn.apply(__global__, [requireProxy, moduleProxy, console])
+      fn.apply(__global__, [requireProxy, moduleProxy, console].concat(natives || []))
     } catch (e) {
       if (__global__.onerror) {
         __global__.onerror(e)
@@ -76,4 +77,11 @@ const commonjs = function (fn, exports, modulePath, __global__) {
   })
 }
 
+// Loads module |name| with the code cache, |natives| are the names bound by
+// the module system for the module.
+const requireModule = function (name, exports, modulePath, __global__, natives) {
+  commonjs(moduleLoader.compile(name), exports, modulePath, __global__, natives)
+}
+
 exports.$set('require', commonjs)
+exports.$set('requireModule', requireModule)
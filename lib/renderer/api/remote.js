@@ -322,6 +322,40 @@ binding.callAsyncWebContentsFunction = function (tabId, name, ...args) {
   ipcRenderer.send('ELECTRON_BROWSER_ASYNC_MEMBER_CALL', tabId, name, wrapArgs(...args))
 }
 
+// Convert the target of a batch operation, which is a remote object or the
+// index of an earlier result in the batch.
+const batchTargetToMeta = function (target) {
+  if (typeof target === 'number') {
+    return {type: 'result', index: target}
+  }
+  if (target != null && privates(target).atomId) {
+    return {type: 'remote-object', id: privates(target).atomId}
+  }
+  throw new TypeError('The target of a batch operation must be a remote object or a result index')
+}
+
+// Run many operations on remote objects in one round trip, e.g.
+// remote.batch([{object: win, call: 'getTitle'}, {object: win, get: 'id'}])
+binding.batch = function (operations) {
+  const request = operations.map((operation) => {
+    const meta = {target: batchTargetToMeta(operation.object)}
+    if (operation.get != null) {
+      meta.type = 'get'
+      meta.name = operation.get
+    } else if (operation.set != null) {
+      meta.type = 'set'
+      meta.name = operation.set
+      meta.value = wrapArgs([operation.value])[0]
+    } else {
+      meta.type = 'call'
+      meta.name = operation.call
+      meta.args = wrapArgs(operation.args || [])
+    }
+    return meta
+  })
+  return ipcRenderer.sendSyncSerialized('ELECTRON_BROWSER_BATCH', request).map(metaToValue)
+}
+
 const deprecatedRemoteAPIs = ['Menu', 'shell', 'screen', 'clipboard', 'session', 'BrowserWindow']
 for (var i = 0, len = deprecatedRemoteAPIs.length; i < len; i++) {
   const name = deprecatedRemoteAPIs[i]
@@ -4,7 +4,7 @@ const https = require('https')
 const net = require('net')
 const fs = require('fs')
 const path = require('path')
-const {remote} = require('electron')
+const {ipcRenderer, remote} = require('electron')
 const {closeWindow} = require('./window-helpers')
 
 const {app, BrowserWindow, ipcMain} = remote
@@ -334,4 +334,137 @@ describe('app module', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.createWorkerPool(moduleName, size)', function () {
+    let pool = null
+
+    before(function () {
+      // Workers load their module from the source root.
+      app.commandLine.appendSwitch('source-root', path.join(__dirname, 'fixtures', 'workers'))
+    })
+
+    afterEach(function () {
+      if (pool) {
+        pool.terminate()
+        pool = null
+      }
+    })
+
+    it('runs messages on the pool workers', function (done) {
+      pool = app.createWorkerPool('pool_worker', 2)
+      assert.equal(pool.workerIds.length, 2)
+      pool.on('message', function (event) {
+        assert.equal(event.data, 'ping')
+        assert.notEqual(pool.workerIds.indexOf(event.workerId), -1)
+        const stats = pool.getStats()
+        assert.equal(stats.workers, 2)
+        assert.equal(stats.queueDepth, 0)
+        done()
+      })
+      pool.postMessage('ping')
+    })
+
+    it('removes its listeners when terminated', function () {
+      const messageListeners = app.listenerCount('worker-post-message')
+      const errorListeners = app.listenerCount('worker-onerror')
+      pool = app.createWorkerPool('pool_worker', 1)
+      assert.equal(app.listenerCount('worker-post-message'), messageListeners + 1)
+      assert.equal(app.listenerCount('worker-onerror'), errorListeners + 1)
+
+      pool.terminate()
+      pool = null
+      assert.equal(app.listenerCount('worker-post-message'), messageListeners)
+      assert.equal(app.listenerCount('worker-onerror'), errorListeners)
+    })
+
+    it('does not add listeners when the pool fails to start', function () {
+      pool = app.createWorkerPool('pool_worker', 1)
+      const messageListeners = app.listenerCount('worker-post-message')
+      assert.throws(function () {
+        app.createWorkerPool('pool_worker', 1)
+      }, /already running/)
+      assert.equal(app.listenerCount('worker-post-message'), messageListeners)
+    })
+
+    it('drops workers whose module fails to load', function (done) {
+      pool = app.createWorkerPool('missing_worker', 2)
+      let errors = 0
+      pool.onerror = function (message) {
+        assert.ok(/No source for require\(missing_worker\)/.test(message))
+        if (++errors < 2) return
+        assert.equal(pool.getStats().workers, 0)
+        pool.postMessage('ping')
+        assert.equal(pool.getStats().queueDepth, 0)
+        done()
+      }
+    })
+
+    // Buffers passed through remote are copied, so these run in the main
+    // process and report back over ipc.
+    describe('postMessage(message, transferList)', function () {
+      afterEach(function () {
+        ipcRenderer.removeAllListeners('worker-spec-result')
+      })
+
+      it('moves transferred ArrayBuffers to the worker', function (done) {
+        ipcRenderer.once('worker-spec-result', function (event, byteLength, received) {
+          assert.equal(byteLength, 0)
+          assert.deepEqual(received, [1, 2, 3])
+          done()
+        })
+        ipcRenderer.sendSync('eval', `
+          const sender = event.sender
+          const pool = require('electron').app.createWorkerPool('transfer_worker', 1)
+          const buffer = new Uint8Array([1, 2, 3]).buffer
+          pool.on('message', function (e) {
+            pool.terminate()
+            sender.send('worker-spec-result', buffer.byteLength, e.data)
+          })
+          pool.postMessage(buffer, [buffer])
+          buffer.byteLength
+        `)
+      })
+
+      it('shares SharedArrayBuffers with the worker', function (done) {
+        if (ipcRenderer.sendSync('eval', 'typeof SharedArrayBuffer') === 'undefined') {
+          return this.skip()
+        }
+        ipcRenderer.once('worker-spec-result', function (event, value) {
+          assert.equal(value, 42)
+          done()
+        })
+        ipcRenderer.sendSync('eval', `
+          const sender = event.sender
+          const pool = require('electron').app.createWorkerPool('transfer_worker', 1)
+          const shared = new Int32Array(new SharedArrayBuffer(4))
+          pool.on('message', function () {
+            pool.terminate()
+            sender.send('worker-spec-result', Atomics.load(shared, 0))
+          })
+          pool.postMessage(shared.buffer)
+          shared.length
+        `)
+      })
+
+      it('rejects entries that can not be transferred', function () {
+        const errors = ipcRenderer.sendSync('eval', `
+          const pool = require('electron').app.createWorkerPool('transfer_worker', 1)
+          const buffer = new ArrayBuffer(8)
+          const errors = [[{}], [new Uint8Array(buffer)], [buffer, buffer]].map(function (list) {
+            try {
+              pool.postMessage(buffer, list)
+              return null
+            } catch (error) {
+              return error.message
+            }
+          })
+          pool.terminate()
+          errors
+        `)
+        assert.ok(/can only contain ArrayBuffers/.test(errors[0]), errors[0])
+        assert.ok(/can only contain ArrayBuffers/.test(errors[1]), errors[1])
+        assert.ok(/more than once/.test(errors[2]), errors[2])
+      })
+    })
+  })
 })
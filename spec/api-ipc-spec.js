@@ -322,6 +322,55 @@ describe('ipc module', function () {
       global.gc()
       assert.equal(method(), 'method')
     })
+
+    it('sees methods added to the prototype after it was sent', function () {
+      const module = remote.require(path.join(fixtures, 'module', 'mutable-prototype.js'))
+      const before = module.create()
+      assert.equal(before.decrement, undefined)
+
+      module.addDecrement()
+      const after = module.create()
+      assert.equal(after.increment(), 1)
+      assert.equal(after.decrement(), 0)
+    })
+  })
+
+  describe('remote.batch', function () {
+    const batch = remote.require(path.join(fixtures, 'module', 'batch.js'))
+
+    beforeEach(function () {
+      batch.count = 0
+    })
+
+    it('can use the results of earlier operations', function () {
+      const win = remote.getCurrentWindow()
+      const [id, , contentsId, url] = remote.batch([
+        {object: win, get: 'id'},
+        {object: win, get: 'webContents'},
+        {object: 1, get: 'id'},
+        {object: 1, call: 'getURL'}
+      ])
+      assert.equal(id, win.id)
+      assert.equal(contentsId, win.webContents.id)
+      assert.equal(url, win.webContents.getURL())
+    })
+
+    it('stops at the first operation that throws', function () {
+      assert.throws(function () {
+        remote.batch([
+          {object: batch, call: 'increment'},
+          {object: batch, call: 'fail'},
+          {object: batch, call: 'increment'}
+        ])
+      }, /batch failure/)
+      assert.equal(batch.count, 1)
+    })
+
+    it('throws when a result can not be cloned', function () {
+      assert.throws(function () {
+        remote.batch([{object: batch, call: 'symbol'}])
+      })
+    })
   })
 
   describe('ipc.sender.send', function () {
@@ -461,6 +510,51 @@ describe('ipc module', function () {
     })
   })
 
+  describe('ipcRenderer.sendRing', function () {
+    afterEach(function () {
+      ipcMain.removeAllListeners('ring-message')
+    })
+
+    it('delivers messages in the order they were sent', function (done) {
+      const count = 100
+      const received = []
+      ipcMain.on('ring-message', function (event, index) {
+        received.push(index)
+        if (received.length === count) {
+          assert.deepEqual(received, Array.from(Array(count).keys()))
+          done()
+        }
+      })
+      for (let i = 0; i < count; i++) {
+        assert.equal(ipcRenderer.sendRing('ring-message', i, {index: i}), true)
+      }
+    })
+
+    it('returns false when the message does not fit', function () {
+      const payload = 'a'.repeat(2 * 1024 * 1024)
+      assert.equal(ipcRenderer.sendRing('ring-message', payload), false)
+    })
+
+    it('returns false when the buffer is full', function (done) {
+      let sent = 0
+      let received = 0
+      ipcMain.on('ring-message', function () {
+        if (++received === sent) done()
+      })
+
+      // Keep the browser from draining the buffer while it is filled, the
+      // signal for the first message is queued behind this.
+      ipcRenderer.send('eval', 'const end = Date.now() + 2000; while (Date.now() < end) {}')
+
+      const payload = 'a'.repeat(256 * 1024)
+      while (sent < 16 && ipcRenderer.sendRing('ring-message', payload)) {
+        sent++
+      }
+      assert(sent > 0)
+      assert(sent < 16)
+    })
+  })
+
   describe('ipcRenderer.sendTo', function () {
     let contents = null
     beforeEach(function () {
@@ -308,6 +308,60 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol.registerStreamProtocol', function () {
+    it('sends the chunks as response', function (done) {
+      var chunks = [new Buffer('valar '), new Buffer('morghulis')]
+      var handler = function (request, callback) {
+        callback({
+          mimeType: 'text/plain',
+          headers: {'X-Great-Header': 'valar dohaeris'},
+          data: function (push) {
+            push(chunks.shift())
+          }
+        })
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data, status, request) {
+            assert.equal(data, text)
+            assert.equal(request.getResponseHeader('X-Great-Header'), 'valar dohaeris')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('fails when data is not a function', function (done) {
+      var handler = function (request, callback) {
+        callback({data: new Buffer(text)})
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+  })
+
   describe('protocol.registerFileProtocol', function () {
     var filePath = path.join(__dirname, 'fixtures', 'asar', 'a.asar', 'file1')
     var fileContent = require('fs').readFileSync(filePath)
@@ -376,6 +376,35 @@ describe('session module', function () {
     })
   })
 
+  describe('ses.userPrefs path access', function () {
+    var userPrefs = null
+    var name = null
+
+    beforeEach(function () {
+      userPrefs = session.defaultSession.userPrefs
+      name = 'spec_user_prefs_' + Date.now()
+    })
+
+    it('invalidates the cached items of a list when one is removed', function () {
+      userPrefs.registerListPref(name, ['a', 'b', 'c'], false)
+      assert.equal(userPrefs.getPref(name + '.1'), 'b')
+      assert.equal(userPrefs.getPref(name + '.2'), 'c')
+      assert.equal(userPrefs.removePref(name + '.0'), true)
+      assert.equal(userPrefs.getPref(name + '.1'), 'c')
+      assert.equal(userPrefs.getPref(name + '.2'), null)
+      assert.deepEqual(userPrefs.getPref(name), ['b', 'c'])
+    })
+
+    it('leaves the pref alone when a set fails', function () {
+      userPrefs.registerDictionaryPref(name, {tabs: ['a']}, false)
+      assert.deepEqual(userPrefs.getPref(name), {tabs: ['a']})
+      assert.equal(userPrefs.setPref(name + '.tabs.5', 'b'), false)
+      assert.equal(userPrefs.removePref(name + '.missing'), false)
+      assert.deepEqual(userPrefs.getPref(name), {tabs: ['a']})
+      assert.deepEqual(userPrefs.getDictionaryPref(name), {tabs: ['a']})
+    })
+  })
+
   describe('ses.setProxy(options, callback)', function () {
     it('allows configuring proxy settings', function (done) {
       const config = {
@@ -85,6 +85,72 @@ describe('webRequest module', function () {
       })
     })
 
+    it('can filter URLs among many patterns', function (done) {
+      var urls = []
+      for (var i = 0; i < 1000; i++) {
+        urls.push('http://*.host' + i + '.com/*')
+        urls.push('*://host' + i + '.org/path/*')
+      }
+      urls.push(defaultURL + 'filter/*')
+      ses.webRequest.onBeforeRequest({urls: urls}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'nofilter/test',
+        success: function (data) {
+          assert.equal(data, '/nofilter/test')
+          $.ajax({
+            url: defaultURL + 'filter/test',
+            success: function () {
+              done('unexpected success')
+            },
+            error: function () {
+              done()
+            }
+          })
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('matches a path without the trailing slash of the pattern', function (done) {
+      ses.webRequest.onBeforeRequest({urls: [defaultURL + 'filter/*']}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'filter',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
+    it('matches escaped paths', function (done) {
+      ses.webRequest.onBeforeRequest({urls: [defaultURL + 'a%20b/*']}, function (details, callback) {
+        callback({
+          cancel: true
+        })
+      })
+      $.ajax({
+        url: defaultURL + 'a b/test',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          done()
+        }
+      })
+    })
+
     it('receives details object', function (done) {
       ses.webRequest.onBeforeRequest(function (details, callback) {
         assert.equal(typeof details.id, 'number')
@@ -107,6 +173,36 @@ describe('webRequest module', function () {
       })
     })
 
+    it('only receives the requested fields', function (done) {
+      var filter = {
+        fields: ['url', 'resourceType']
+      }
+      ses.webRequest.onBeforeRequest(filter, function (details, callback) {
+        assert.equal(details.url, defaultURL)
+        assert.equal(details.resourceType, 'xhr')
+        assert.equal(details.id, undefined)
+        assert.equal(details.method, undefined)
+        assert.equal(details.timestamp, undefined)
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('throws for unknown fields', function () {
+      assert.throws(function () {
+        ses.webRequest.onBeforeRequest({fields: ['unknown']}, function () {})
+      }, /Unknown details field/)
+    })
+
     it('receives post data in details object', function (done) {
       var postData = {
         name: 'post test',
@@ -431,6 +527,36 @@ describe('webRequest module', function () {
         }
       })
     })
+
+    it('can receive the events in batches', function (done) {
+      var urls = [defaultURL + 'batch1', defaultURL + 'batch2']
+      var received = []
+      ses.webRequest.onCompleted({urls: urls, batchInterval: 50}, function (detailsArray, dropped) {
+        assert.equal(dropped, 0)
+        detailsArray.forEach(function (details) {
+          assert.equal(details.statusCode, 200)
+          received.push(details.url)
+        })
+        if (received.length === urls.length) {
+          assert.deepEqual(received.sort(), urls)
+          done()
+        }
+      })
+      urls.forEach(function (url) {
+        $.ajax({
+          url: url,
+          error: function (xhr, errorType) {
+            done(errorType)
+          }
+        })
+      })
+    })
+
+    it('throws for invalid batch intervals', function () {
+      assert.throws(function () {
+        ses.webRequest.onCompleted({batchInterval: 0}, function () {})
+      }, /batchInterval must be a positive Number/)
+    })
   })
 
   describe('webRequest.onErrorOccurred', function () {
@@ -457,4 +583,91 @@ describe('webRequest module', function () {
       })
     })
   })
+
+  describe('webRequest.setRules', function () {
+    afterEach(function () {
+      ses.webRequest.setRules(null)
+    })
+
+    it('can block requests', function (done) {
+      ses.webRequest.setRules([{action: 'block', urls: [defaultURL + 'blocked']}])
+      $.ajax({
+        url: defaultURL + 'blocked',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          $.ajax({
+            url: defaultURL + 'allowed',
+            success: function (data) {
+              assert.equal(data, '/allowed')
+              done()
+            },
+            error: function (xhr, errorType) {
+              done(errorType)
+            }
+          })
+        }
+      })
+    })
+
+    it('can redirect requests', function (done) {
+      ses.webRequest.setRules([{
+        action: 'redirect',
+        urls: [defaultURL + 'from'],
+        redirectURL: defaultURL + 'to'
+      }])
+      $.ajax({
+        url: defaultURL + 'from',
+        success: function (data) {
+          assert.equal(data, '/to')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('can change the request and response headers', function (done) {
+      ses.webRequest.setRules([
+        {action: 'setRequestHeader', name: 'Accept', value: '*/*;test/header'},
+        {action: 'setResponseHeader', name: 'Custom', value: 'Changed'}
+      ])
+      $.ajax({
+        url: defaultURL,
+        success: function (data, status, xhr) {
+          assert.equal(xhr.getResponseHeader('Custom'), 'Changed')
+          assert.equal(data, '/header/received')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('only applies to the given resource types', function (done) {
+      ses.webRequest.setRules([{action: 'block', resourceTypes: ['image']}])
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('throws for invalid rules', function () {
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'unknown'}])
+      }, /Unknown rule action: unknown/)
+      assert.throws(function () {
+        ses.webRequest.setRules([{action: 'redirect', redirectURL: 'invalid'}])
+      }, /Invalid redirectURL: invalid/)
+    })
+  })
 })
@@ -37,6 +37,13 @@ describe('asar package', function () {
         assert.equal(fs.readFileSync(file3).toString().trim(), 'file3')
       })
 
+      it('reads a compressed file', function () {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'a.txt')
+        assert.equal(fs.readFileSync(p, 'utf8'), 'compressed\n')
+        p = path.join(fixtures, 'asar', 'compressed.asar', 'b.txt')
+        assert.equal(fs.readFileSync(p, 'utf8'), 'raw\n')
+      })
+
       it('reads from a empty file', function () {
         var file = path.join(fixtures, 'asar', 'empty.asar', 'file1')
         var buffer = fs.readFileSync(file)
@@ -90,6 +97,15 @@ describe('asar package', function () {
         })
       })
 
+      it('reads a compressed file', function (done) {
+        var p = path.join(fixtures, 'asar', 'compressed.asar', 'a.txt')
+        fs.readFile(p, 'utf8', function (err, content) {
+          assert.equal(err, null)
+          assert.equal(content, 'compressed\n')
+          done()
+        })
+      })
+
       it('reads from a empty file', function (done) {
         var p = path.join(fixtures, 'asar', 'empty.asar', 'file1')
         fs.readFile(p, function (err, content) {
@@ -670,6 +686,32 @@ describe('asar package', function () {
       })
     })
 
+    describe('extraction cache', function () {
+      // Archives created here do not share the copies of the registry's.
+      var asar = remote.process.binding('atom_common_asar')
+      var archivePath = path.join(fixtures, 'asar', 'a.asar')
+
+      function copyFileOut (filePath) {
+        var archive = asar.createArchive(archivePath)
+        var newPath = archive.copyFileOut(filePath)
+        archive.destroy()
+        return newPath
+      }
+
+      it('extracts again a cached file that was corrupted', function () {
+        var contents = fs.readFileSync(path.join(archivePath, 'file1'))
+        var cached = copyFileOut('file1')
+        var cacheDir = path.join(remote.app.getPath('userData'), 'AsarCache')
+        assert.equal(path.dirname(cached), cacheDir)
+        assert.ok(fs.existsSync(cached + '.sha256'))
+
+        // Same size, so only the hash can tell.
+        fs.writeFileSync(cached, Buffer.alloc(contents.length, 'x'))
+        assert.equal(copyFileOut('file1'), cached)
+        assert.deepEqual(fs.readFileSync(cached), contents)
+      })
+    })
+
     describe('internalModuleReadFile', function () {
       var internalModuleReadFile = process.binding('fs').internalModuleReadFile
 
@@ -774,6 +816,14 @@ describe('asar package', function () {
       })
     })
 
+    it('can request a compressed file in package', function (done) {
+      var p = path.resolve(fixtures, 'asar', 'compressed.asar', 'dir', 'c.html')
+      $.get('file://' + p, function (data) {
+        assert.equal(data.trim(), '<html><body>compressed page</body></html>')
+        done()
+      })
+    })
+
     it('can request a linked file in package', function (done) {
       var p = path.resolve(fixtures, 'asar', 'a.asar', 'link2', 'link1')
       $.get('file://' + p, function (data) {
@@ -782,6 +832,20 @@ describe('asar package', function () {
       })
     })
 
+    it('counts archives opened by the protocol', function (done) {
+      var asar = remote.process.binding('atom_common_asar')
+      var before = asar.getArchiveRegistryStats()
+      var p = path.resolve(fixtures, 'asar', 'a.asar', 'file2')
+      $.get('file://' + p, function (data) {
+        assert.equal(data.trim(), 'file2')
+        var after = asar.getArchiveRegistryStats()
+        assert.ok(after.hits + after.misses > before.hits + before.misses)
+        assert.ok(after.openArchives >= 1)
+        assert.ok(after.openFds >= after.openArchives)
+        done()
+      })
+    })
+
     it('can request a file in filesystem', function (done) {
       var p = path.resolve(fixtures, 'asar', 'file')
       $.get('file://' + p, function (data) {
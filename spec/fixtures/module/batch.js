@@ -0,0 +1,13 @@
+exports.count = 0
+
+exports.increment = function () {
+  return ++exports.count
+}
+
+exports.fail = function () {
+  throw new Error('batch failure')
+}
+
+exports.symbol = function () {
+  return Symbol('batch')
+}
@@ -0,0 +1,19 @@
+class Counter {
+  constructor () {
+    this.count = 0
+  }
+
+  increment () {
+    return ++this.count
+  }
+}
+
+exports.create = function () {
+  return new Counter()
+}
+
+exports.addDecrement = function () {
+  Counter.prototype.decrement = function () {
+    return --this.count
+  }
+}
@@ -0,0 +1,3 @@
+self.onmessage = function (event) {
+  postMessage(event.data)
+}
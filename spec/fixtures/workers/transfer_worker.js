@@ -0,0 +1,9 @@
+self.onmessage = function (event) {
+  if (typeof SharedArrayBuffer !== 'undefined' &&
+      event.data instanceof SharedArrayBuffer) {
+    Atomics.store(new Int32Array(event.data), 0, 42)
+    postMessage('stored')
+  } else {
+    postMessage(Array.from(new Uint8Array(event.data)))
+  }
+}